@@ -14,6 +14,7 @@ public:
     virtual ~ISubsystem() = default;
     virtual void initialize() = 0;
     virtual void update() = 0;
+    virtual void enable() = 0;      // Resume after disable() without re-running initialize()
     virtual void disable() = 0;
     virtual bool isEnabled() const = 0;
     virtual const std::string& getName() const = 0;
@@ -39,6 +40,7 @@ public:
         : name_(name), config_(config) {}
 
     virtual void initialize() override { enabled_ = true; }
+    virtual void enable() override { enabled_ = true; }
     virtual void disable() override { enabled_ = false; }
     virtual bool isEnabled() const override { return enabled_; }
     virtual const std::string& getName() const override { return name_; }
@@ -97,6 +99,12 @@ public:
         }
     }
 
+    void enableAll() {
+        for (auto& [name, subsystem] : subsystems_) {
+            subsystem->enable();
+        }
+    }
+
     void disableAll() {
         for (auto& [name, subsystem] : subsystems_) {
             subsystem->disable();
@@ -0,0 +1,72 @@
+#pragma once
+#include "main.h"
+#include "movement/auton_selector.hpp"
+#include "pros/llemu.hpp"
+#include <cstdint>
+#include <string>
+
+namespace display {
+
+// Brain-screen routine picker for the pre-match window.
+// Left/Right cycle routines, Center switches alliance.
+class AutonSelectorScreen {
+private:
+    movement::AutonSelector& selector_;
+    std::uint8_t last_buttons_ = 0;
+    bool shown_ready_ = false;          // Preparation result is on screen
+
+    void draw() {
+        size_t index = selector_.getSelected();
+        bool red = selector_.getAlliance() == movement::Alliance::RED;
+
+        pros::lcd::set_text(0, "== Auton Select ==");
+        pros::lcd::set_text(1, "< " + selector_.getRoutineName(index) + " >");
+        pros::lcd::set_text(2, red ? "Alliance: RED" : "Alliance: BLUE");
+        if (!shown_ready_) {
+            pros::lcd::set_text(3, "Preparing...");
+        } else {
+            pros::lcd::set_text(3, selector_.isReady() ? "Ready" : "Not available");
+        }
+        pros::lcd::set_text(4, "L/R:Routine C:Alliance");
+    }
+
+public:
+    explicit AutonSelectorScreen(movement::AutonSelector& selector)
+        : selector_(selector) {}
+
+    // Poll the buttons and refresh the screen; call from the pre-match loop
+    void update() {
+        size_t count = selector_.getRoutineCount();
+        if (count == 0) return;
+
+        std::uint8_t buttons = pros::lcd::read_buttons();
+        std::uint8_t pressed = buttons & ~last_buttons_;
+        last_buttons_ = buttons;
+
+        size_t index = selector_.getSelected();
+        movement::Alliance alliance = selector_.getAlliance();
+        bool changed = true;
+        if (pressed & LCD_BTN_LEFT) {
+            index = (index + count - 1) % count;
+        } else if (pressed & LCD_BTN_RIGHT) {
+            index = (index + 1) % count;
+        } else if (pressed & LCD_BTN_CENTER) {
+            alliance = alliance == movement::Alliance::RED ? movement::Alliance::BLUE : movement::Alliance::RED;
+        } else {
+            changed = false;
+        }
+
+        if (changed) {
+            selector_.select(index, alliance);
+            shown_ready_ = false;
+            draw();
+        } else if (!shown_ready_ && !selector_.isPreparing()) {
+            shown_ready_ = true;
+            draw();
+        }
+    }
+
+    void show() { draw(); }
+};
+
+} // namespace display
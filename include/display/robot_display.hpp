@@ -24,9 +24,8 @@ private:
         std::string motor_text = "Motors: ";
         auto& chassis = robot_.getChassis();
         for (int i = 0; i < chassis.getMotorCount(); i++) {
-            const auto& motor = chassis.getMotor(i);
             motor_text += "M" + std::to_string(i+1) + ":" + 
-                         std::to_string(static_cast<int>(motor.get_actual_velocity())) + " ";
+                         std::to_string(static_cast<int>(chassis.getMotorRpm(i))) + " ";
         }
         pros::lcd::set_text(2, motor_text);
 
@@ -34,6 +33,9 @@ private:
         std::string mode_text = robot_.isDevMode() ? "DEV MODE" : "COMP MODE";
         pros::lcd::set_text(3, mode_text);
 
+        // Update sensor status
+        pros::lcd::set_text(6, robot_.areSensorsReady() ? "Sensors: READY" : "Sensors: CALIBRATING");
+
         // Check button presses manually
         if (pros::lcd::read_buttons() & LCD_BTN_LEFT) {
             robot_.getClamp().toggle();
@@ -0,0 +1,164 @@
+#pragma once
+#include "main.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace movement {
+
+// Hardware a macro needs exclusive use of. Starting a macro interrupts any
+// running macro whose requirements overlap.
+enum Resource : std::uint32_t {
+    RESOURCE_NONE = 0,
+    RESOURCE_CHASSIS = 1u << 0,
+    RESOURCE_CLAMP = 1u << 1
+};
+
+// Base macro interface
+class Macro {
+public:
+    virtual ~Macro() = default;
+    virtual void execute() = 0;
+    virtual bool isComplete() const = 0;
+    virtual void reset() = 0;
+    virtual void cancel() {}        // Stop mid-run; the next reset() starts over
+    virtual std::uint32_t requirements() const { return RESOURCE_NONE; }
+};
+
+using MacroList = std::vector<std::unique_ptr<Macro>>;
+
+// Runs children one after another. A child that finishes hands over to the
+// next one in the same tick, so instant steps cost no time.
+class SequentialGroup : public Macro {
+private:
+    MacroList children_;
+    size_t index_ = 0;
+    std::uint32_t requirements_ = RESOURCE_NONE;
+
+public:
+    explicit SequentialGroup(MacroList children)
+        : children_(std::move(children))
+        , index_(children_.size()) {
+        for (const auto& child : children_) requirements_ |= child->requirements();
+    }
+
+    void execute() override {
+        while (index_ < children_.size()) {
+            children_[index_]->execute();
+            if (!children_[index_]->isComplete()) return;
+            if (++index_ < children_.size()) children_[index_]->reset();
+        }
+    }
+
+    bool isComplete() const override { return index_ >= children_.size(); }
+
+    void reset() override {
+        index_ = 0;
+        if (!children_.empty()) children_[0]->reset();
+    }
+
+    void cancel() override {
+        if (index_ < children_.size()) children_[index_]->cancel();
+        index_ = children_.size();
+    }
+
+    std::uint32_t requirements() const override { return requirements_; }
+};
+
+// How a parallel group decides it is finished
+enum class ParallelMode : std::uint8_t {
+    ALL,        // Every child has finished
+    RACE,       // Any child has finished; the rest are cancelled
+    DEADLINE    // The first child has finished; the rest are cancelled
+};
+
+// Runs children side by side, each advanced once per tick. Children must not
+// share resources with each other.
+class ParallelGroup : public Macro {
+private:
+    MacroList children_;
+    ParallelMode mode_;
+    bool finished_ = true;
+    std::uint32_t requirements_ = RESOURCE_NONE;
+
+    void cancelRunning() {
+        for (auto& child : children_) {
+            if (!child->isComplete()) child->cancel();
+        }
+    }
+
+public:
+    ParallelGroup(ParallelMode mode, MacroList children)
+        : children_(std::move(children))
+        , mode_(mode) {
+        for (const auto& child : children_) requirements_ |= child->requirements();
+    }
+
+    void execute() override {
+        if (finished_) return;
+
+        bool all = true;
+        bool any = false;
+        for (auto& child : children_) {
+            if (!child->isComplete()) child->execute();
+            bool complete = child->isComplete();
+            all = all && complete;
+            any = any || complete;
+        }
+
+        switch (mode_) {
+            case ParallelMode::ALL:      finished_ = all; break;
+            case ParallelMode::RACE:     finished_ = any; break;
+            case ParallelMode::DEADLINE: finished_ = children_.empty() || children_[0]->isComplete(); break;
+        }
+        if (finished_) cancelRunning();
+    }
+
+    bool isComplete() const override { return finished_; }
+
+    void reset() override {
+        finished_ = children_.empty();
+        for (auto& child : children_) child->reset();
+    }
+
+    void cancel() override {
+        cancelRunning();
+        finished_ = true;
+    }
+
+    std::uint32_t requirements() const override { return requirements_; }
+};
+
+// Group builders, e.g. sequence(drive, parallel(turn, clamp))
+template<typename... Macros>
+MacroList macroList(Macros&&... macros) {
+    MacroList list;
+    list.reserve(sizeof...(macros));
+    (list.push_back(std::forward<Macros>(macros)), ...);
+    return list;
+}
+
+template<typename... Macros>
+std::unique_ptr<Macro> sequence(Macros&&... macros) {
+    return std::make_unique<SequentialGroup>(macroList(std::forward<Macros>(macros)...));
+}
+
+template<typename... Macros>
+std::unique_ptr<Macro> parallel(Macros&&... macros) {
+    return std::make_unique<ParallelGroup>(ParallelMode::ALL, macroList(std::forward<Macros>(macros)...));
+}
+
+template<typename... Macros>
+std::unique_ptr<Macro> race(Macros&&... macros) {
+    return std::make_unique<ParallelGroup>(ParallelMode::RACE, macroList(std::forward<Macros>(macros)...));
+}
+
+// Runs the others alongside the first and stops them when it finishes
+template<typename... Macros>
+std::unique_ptr<Macro> deadline(std::unique_ptr<Macro> first, Macros&&... others) {
+    return std::make_unique<ParallelGroup>(ParallelMode::DEADLINE,
+                                           macroList(std::move(first), std::forward<Macros>(others)...));
+}
+
+} // namespace movement
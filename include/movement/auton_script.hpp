@@ -0,0 +1,316 @@
+#pragma once
+#include "main.h"
+#include "movement/chassis.hpp"
+#include "core/subsystem.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace movement {
+
+// Autonomous script bytecode, produced on the host by tools/compile_auton.py.
+// A file is a ScriptHeader followed by `count` fixed-size instructions.
+struct ScriptHeader {
+    static constexpr std::uint32_t kMagic = 0x53545541;    // "AUTS"
+    static constexpr std::uint16_t kVersion = 1;
+
+    std::uint32_t magic = kMagic;
+    std::uint16_t version = kVersion;
+    std::uint16_t count = 0;
+};
+
+enum ScriptOp : std::uint8_t {
+    OP_END = 0,         // Finish the current lane
+    OP_MOVE_TO = 1,     // a = x, b = y (inches); FLAG_REVERSE drives backwards
+    OP_TURN_TO = 2,     // a = heading (degrees, clockwise positive)
+    OP_CLAMP = 3,       // arg = ClampCommand
+    OP_WAIT = 4,        // arg = milliseconds
+    OP_FORK = 5,        // Run the next `arg` instructions in a new lane and skip past them
+    OP_JOIN = 6         // Wait for every other lane to finish; only valid outside forked blocks
+};
+
+enum ScriptFlag : std::uint8_t {
+    FLAG_REVERSE = 1u << 0,
+    FLAG_CHAIN = 1u << 1    // Intermediate point of a followed path; driven through without stopping
+};
+
+enum class ClampCommand : std::uint8_t {
+    RELEASE = 0,
+    GRAB = 1,
+    TOGGLE = 2
+};
+
+struct ScriptInstruction {
+    std::uint8_t op;
+    std::uint8_t flags;
+    std::uint16_t arg;
+    float a;
+    float b;
+};
+static_assert(sizeof(ScriptInstruction) == 12, "Script instructions are 12 bytes on disk");
+
+enum class ScriptFault : std::uint8_t {
+    INVALID,        // Loaded file failed validation and was discarded
+    LANE_LIMIT      // A parallel block was skipped because every lane was busy
+};
+
+// Published on "script_error"
+struct ScriptErrorEvent {
+    ScriptFault fault;
+    std::uint16_t pc;               // Instruction at fault; 0 for INVALID
+};
+
+// A compiled script read from the SD card. Reading touches no interpreter state,
+// so it can be done on any task and handed to AutonScript::load() later.
+struct ScriptProgram {
+    static constexpr size_t kMaxInstructions = 256;
+
+    std::array<ScriptInstruction, kMaxInstructions> instructions{};
+    std::uint16_t count = 0;
+
+    // False if the file is missing or malformed
+    bool read(const std::string& path) {
+        count = 0;
+        if (!pros::usd::is_installed()) return false;
+
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        ScriptHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  header.magic == ScriptHeader::kMagic &&
+                  header.version == ScriptHeader::kVersion &&
+                  header.count <= kMaxInstructions &&
+                  std::fread(instructions.data(), sizeof(ScriptInstruction), header.count, file) == header.count;
+        std::fclose(file);
+
+        count = ok ? header.count : 0;
+        return count > 0;
+    }
+
+    // Scripts are written for red; flip across the field midline
+    // (y -> 144 - y, headings negated) for blue
+    void mirror() {
+        for (std::uint16_t i = 0; i < count; i++) {
+            auto& ins = instructions[i];
+            if (ins.op == OP_MOVE_TO) ins.b = static_cast<float>(field::FIELD_HEIGHT - ins.b);
+            if (ins.op == OP_TURN_TO) ins.a = -ins.a;
+        }
+    }
+
+    // Reject scripts whose forks run past the end, that use unknown opcodes, or
+    // that join inside a forked block (it would wait on the lane waiting for it)
+    bool validate() const {
+        std::uint32_t forked_until = 0;     // End of the outermost fork block covering i
+        for (std::uint16_t i = 0; i < count; i++) {
+            const auto& ins = instructions[i];
+            if (ins.op > OP_JOIN) return false;
+            if (ins.op == OP_FORK && i + 1 + ins.arg > count) return false;
+            if (ins.op == OP_FORK) forked_until = std::max<std::uint32_t>(forked_until, i + 1 + ins.arg);
+            if (ins.op == OP_JOIN && i < forked_until) return false;
+            if (ins.op == OP_CLAMP && ins.arg > static_cast<std::uint16_t>(ClampCommand::TOGGLE)) return false;
+        }
+        return true;
+    }
+};
+
+// Interprets a loaded script one step per tick. Storage is fixed, so loading
+// and running never allocate.
+template<typename ChassisConfig>
+class AutonScript : public core::ISubsystem {
+public:
+    static constexpr size_t kMaxInstructions = ScriptProgram::kMaxInstructions;
+    static constexpr size_t kMaxLanes = 4;
+
+private:
+    // One thread of execution; lane 0 is the script itself, the rest come from OP_FORK
+    struct Lane {
+        std::uint16_t pc = 0;
+        std::uint16_t end = 0;          // One past the lane's last instruction
+        std::uint32_t motion = 0;       // Chassis motion being waited on
+        std::uint32_t wait_until = 0;
+        bool waiting = false;           // Blocked on motion, wait_until or a join
+        bool active = false;
+        bool chained = false;           // Last motion was a path point; queue the next one behind it
+    };
+
+    std::string name_;
+    Chassis<ChassisConfig>& chassis_;
+    std::function<void(ClampCommand)> clamp_;
+    std::array<ScriptInstruction, kMaxInstructions> program_{};
+    std::array<Lane, kMaxLanes> lanes_{};
+    std::uint16_t count_ = 0;
+    bool enabled_ = false;
+
+    bool otherLanesActive(size_t self) const {
+        for (size_t i = 0; i < kMaxLanes; i++) {
+            if (i != self && lanes_[i].active) return true;
+        }
+        return false;
+    }
+
+    // Still blocked on the instruction that last suspended the lane
+    bool blocked(size_t index) const {
+        const Lane& lane = lanes_[index];
+        if (!lane.waiting) return false;
+
+        switch (program_[lane.pc - 1].op) {
+            case OP_MOVE_TO:
+            case OP_TURN_TO:
+                return chassis_.getMotionResult(lane.motion) == MotionResult::RUNNING;
+            case OP_WAIT:
+                return static_cast<std::int32_t>(pros::millis() - lane.wait_until) < 0;
+            case OP_JOIN:
+                return otherLanesActive(index);
+            default:
+                return false;
+        }
+    }
+
+    void fork(std::uint16_t begin, std::uint16_t end) {
+        for (auto& lane : lanes_) {
+            if (!lane.active) {
+                lane = Lane{begin, end, 0, 0, false, true, false};
+                return;
+            }
+        }
+        core::EventSystem::getInstance().emit("script_error", ScriptErrorEvent{ScriptFault::LANE_LIMIT, begin});
+    }
+
+    // Run instructions until one blocks or the lane ends
+    void stepLane(size_t index) {
+        if (blocked(index)) return;
+
+        Lane& lane = lanes_[index];
+        lane.waiting = false;
+        while (lane.active) {
+            if (lane.pc >= lane.end) {
+                lane.active = false;
+                return;
+            }
+
+            const ScriptInstruction& ins = program_[lane.pc++];
+            switch (ins.op) {
+                case OP_END:
+                    lane.active = false;
+                    return;
+                case OP_MOVE_TO: {
+                    field::Point point(ins.a, ins.b);
+                    bool reverse = ins.flags & FLAG_REVERSE;
+
+                    // Path points are queued and the lane moves straight on to the next one
+                    if (ins.flags & FLAG_CHAIN) {
+                        std::uint32_t id = lane.chained ? chassis_.queueMoveTo(point, reverse, chainedMotion())
+                                                        : chassis_.startMoveTo(point, reverse, chainedMotion());
+                        lane.chained = id != 0;
+                        break;
+                    }
+                    lane.motion = lane.chained ? chassis_.queueMoveTo(point, reverse)
+                                               : chassis_.startMoveTo(point, reverse);
+                    lane.chained = false;
+                    lane.waiting = true;
+                    return;
+                }
+                case OP_TURN_TO:
+                    lane.motion = lane.chained ? chassis_.queueTurnTo(ins.a * M_PI / 180.0)
+                                               : chassis_.startTurnTo(ins.a * M_PI / 180.0);
+                    lane.chained = false;
+                    lane.waiting = true;
+                    return;
+                case OP_CLAMP:
+                    if (clamp_) clamp_(static_cast<ClampCommand>(ins.arg));
+                    break;
+                case OP_WAIT:
+                    lane.wait_until = pros::millis() + ins.arg;
+                    lane.waiting = true;
+                    return;
+                case OP_FORK:
+                    fork(lane.pc, lane.pc + ins.arg);
+                    lane.pc += ins.arg;
+                    break;
+                case OP_JOIN:
+                    if (otherLanesActive(index)) {
+                        lane.waiting = true;
+                        return;
+                    }
+                    break;
+            }
+        }
+    }
+
+public:
+    AutonScript(const std::string& name, Chassis<ChassisConfig>& chassis,
+                std::function<void(ClampCommand)> clamp = nullptr)
+        : name_(name), chassis_(chassis), clamp_(std::move(clamp)) {}
+
+    // ISubsystem interface implementation
+    void initialize() override { enabled_ = true; }
+    void enable() override { enabled_ = true; }
+    void update() override {
+        if (!enabled_) return;
+        for (size_t i = 0; i < kMaxLanes; i++) {
+            if (lanes_[i].active) stepLane(i);
+        }
+    }
+    void disable() override {
+        enabled_ = false;
+        stop();
+    }
+    bool isEnabled() const override { return enabled_; }
+    const std::string& getName() const override { return name_; }
+
+    // Install a program read ahead of time; false if it is empty. A program that
+    // fails validation is also reported on "script_error" and discarded.
+    bool load(const ScriptProgram& program) {
+        stop();
+        count_ = 0;
+        if (program.count == 0) return false;
+        if (!program.validate()) {
+            core::EventSystem::getInstance().emit("script_error", ScriptErrorEvent{ScriptFault::INVALID, 0});
+            return false;
+        }
+        std::copy_n(program.instructions.begin(), program.count, program_.begin());
+        count_ = program.count;
+        return true;
+    }
+
+    // Read a compiled script from the SD card and install it; false if it is
+    // missing, malformed or invalid. `mirror` flips it for blue.
+    bool load(const std::string& path, bool mirror = false) {
+        ScriptProgram program;
+        program.read(path);
+        if (mirror) program.mirror();
+        return load(program);
+    }
+
+    void start() {
+        stop();
+        if (count_ > 0) lanes_[0] = Lane{0, count_, 0, 0, false, true, false};
+    }
+
+    // Abandon every lane and stop any motion the script started
+    void stop() {
+        for (auto& lane : lanes_) {
+            bool owns_motion = chassis_.getMotionResult(lane.motion) == MotionResult::RUNNING;
+            if (lane.active && (owns_motion || lane.chained)) {
+                chassis_.cancelMotion();
+            }
+            lane = Lane{};
+        }
+    }
+
+    bool isLoaded() const { return count_ > 0; }
+
+    bool isRunning() const {
+        for (const auto& lane : lanes_) {
+            if (lane.active) return true;
+        }
+        return false;
+    }
+};
+
+} // namespace movement
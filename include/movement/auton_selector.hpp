@@ -0,0 +1,222 @@
+#pragma once
+#include "main.h"
+#include "constants/fieldConstants.hpp"
+#include "movement/action_graph.hpp"
+#include "movement/odometry.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace movement {
+
+enum class Alliance : std::uint8_t {
+    RED,
+    BLUE
+};
+
+// Routines are written for red. Blue starts on the other side of the field,
+// so its coordinates are red's mirrored across the midline (y -> 144 - y),
+// which also negates headings.
+inline field::Point allianceMirror(const field::Point& point, Alliance alliance) {
+    if (alliance == Alliance::RED) return point;
+    return field::Point(point.x, field::FIELD_HEIGHT - point.y);
+}
+
+inline double allianceHeading(double heading, Alliance alliance) {
+    return alliance == Alliance::RED ? heading : -heading;
+}
+
+inline Position allianceMirror(const Position& pose, Alliance alliance) {
+    field::Point point = allianceMirror(field::Point(pose.x, pose.y), alliance);
+    return Position(point.x, point.y, allianceHeading(pose.heading, alliance));
+}
+
+// Everything a routine needs on its first tick
+struct AutonPlan {
+    Alliance alliance = Alliance::RED;
+    Position start;                         // Already mirrored for the alliance
+    std::vector<field::Point> waypoints;    // Already mirrored for the alliance
+    std::unique_ptr<Macro> macro;           // Ready to start
+};
+
+// `build` runs on the prepare task. It may read files and allocate, but must
+// leave shared robot state alone; data it reads goes into the macro, which
+// installs it when it runs on the autonomous task.
+struct AutonRoutine {
+    std::string name;
+    Position start;                         // Red coordinates; odometry is placed here when the routine starts
+    std::vector<field::Point> waypoints;    // Red coordinates
+    std::function<std::unique_ptr<Macro>(const AutonPlan&)> build;     // Null macro if the plan cannot run
+};
+
+// Holds the routine chosen before the match and prepares its plan on a
+// low-priority task, so autonomous() only has to start it
+class AutonSelector {
+private:
+    static constexpr std::uint32_t kPrepareTimeoutMs = 2000;
+
+    std::vector<AutonRoutine> routines_;
+    size_t selected_ = 0;
+    Alliance alliance_ = Alliance::RED;
+
+    // Selection generation: bumped on every change, compared when a plan is done
+    std::atomic<std::uint32_t> requested_{0};
+    std::uint32_t prepared_ = 0;
+    AutonPlan plan_;
+    mutable pros::Mutex mutex_;             // Guards selected_, alliance_, plan_ and prepared_
+    std::unique_ptr<pros::Task> task_;
+
+    AutonPlan build(size_t index, Alliance alliance) const {
+        const auto& routine = routines_[index];
+        AutonPlan plan;
+        plan.alliance = alliance;
+        plan.start = allianceMirror(routine.start, alliance);
+        plan.waypoints.reserve(routine.waypoints.size());
+        for (const auto& point : routine.waypoints) {
+            plan.waypoints.push_back(allianceMirror(point, alliance));
+        }
+        if (routine.build) plan.macro = routine.build(plan);
+        return plan;
+    }
+
+    // Background loop; a plan finished for an outdated selection is discarded
+    void prepareLoop() {
+        std::uint32_t done = 0;
+        while (true) {
+            std::uint32_t request = requested_;
+            if (request == done) {
+                pros::delay(20);
+                continue;
+            }
+
+            size_t index;
+            Alliance alliance;
+            {
+                std::lock_guard<pros::Mutex> lock(mutex_);
+                index = selected_;
+                alliance = alliance_;
+            }
+            AutonPlan plan = build(index, alliance);
+
+            std::lock_guard<pros::Mutex> lock(mutex_);
+            if (requested_ == request) {
+                plan_ = std::move(plan);
+                prepared_ = request;
+            }
+            done = request;
+        }
+    }
+
+public:
+    // Register routines before the first select()
+    void addRoutine(AutonRoutine routine) {
+        routines_.push_back(std::move(routine));
+    }
+
+    // Choose a routine and start preparing it in the background
+    void select(size_t index, Alliance alliance) {
+        if (index >= routines_.size()) return;
+        {
+            std::lock_guard<pros::Mutex> lock(mutex_);
+            selected_ = index;
+            alliance_ = alliance;
+            requested_++;
+        }
+        if (!task_) {
+            task_ = std::make_unique<pros::Task>([this]() { prepareLoop(); },
+                                                 TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT,
+                                                 "auton_prepare");
+        }
+    }
+
+    // True once the plan for the current selection is built
+    bool isReady() {
+        std::lock_guard<pros::Mutex> lock(mutex_);
+        return prepared_ == requested_ && plan_.macro != nullptr;
+    }
+
+    // True while the background task is still building the current selection
+    bool isPreparing() {
+        std::lock_guard<pros::Mutex> lock(mutex_);
+        return prepared_ != requested_;
+    }
+
+    // Hand over the prepared plan. Waits for a plan still being prepared, and
+    // builds one on the spot if nothing was ever selected; no macro with no routines.
+    AutonPlan takePlan() {
+        if (routines_.empty()) return AutonPlan{};
+
+        std::uint32_t start = pros::millis();
+        while (task_ && isPreparing() && pros::millis() - start < kPrepareTimeoutMs) {
+            pros::delay(5);
+        }
+
+        size_t index;
+        Alliance alliance;
+        {
+            std::lock_guard<pros::Mutex> lock(mutex_);
+            if (prepared_ == requested_ && plan_.macro) {
+                return std::move(plan_);
+            }
+            index = selected_;
+            alliance = alliance_;
+        }
+        return build(index, alliance);
+    }
+
+    size_t getRoutineCount() const { return routines_.size(); }
+    size_t getSelected() const {
+        std::lock_guard<pros::Mutex> lock(mutex_);
+        return selected_;
+    }
+
+    Alliance getAlliance() const {
+        std::lock_guard<pros::Mutex> lock(mutex_);
+        return alliance_;
+    }
+
+    const std::string& getRoutineName(size_t index) const { return routines_.at(index).name; }
+};
+
+// Stands in for the selected routine so it can be registered with MacroSystem
+// once at startup; each start takes the freshly prepared macro and places the
+// robot at the plan's start pose
+class SelectedRoutine : public Macro {
+private:
+    AutonSelector& selector_;
+    std::function<void(const Position&)> place_;
+    std::unique_ptr<Macro> macro_;
+
+public:
+    explicit SelectedRoutine(AutonSelector& selector,
+                             std::function<void(const Position&)> place = nullptr)
+        : selector_(selector), place_(std::move(place)) {}
+
+    void execute() override {
+        if (macro_) macro_->execute();
+    }
+
+    bool isComplete() const override { return !macro_ || macro_->isComplete(); }
+
+    void reset() override {
+        AutonPlan plan = selector_.takePlan();
+        macro_ = std::move(plan.macro);
+        if (!macro_) return;
+        if (place_) place_(plan.start);
+        macro_->reset();
+    }
+
+    void cancel() override {
+        if (macro_) macro_->cancel();
+    }
+
+    std::uint32_t requirements() const override {
+        return macro_ ? macro_->requirements() : (RESOURCE_CHASSIS | RESOURCE_CLAMP);
+    }
+};
+
+} // namespace movement
@@ -0,0 +1,64 @@
+#pragma once
+#include "main.h"
+#include "pros/misc.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace movement {
+
+struct BatteryConfig {
+    double nominal_voltage = 12.8;      // Volts of a full battery; the drive reaches full speed here
+    double reference_voltage = 11.5;    // Volts the drive is limited to: a battery at the end of a match,
+                                        // so fresh and tired batteries drive the same
+    std::uint32_t filter_ms = 500;      // Time constant of the voltage filter
+};
+
+// Filtered battery voltage and the share of the drive's top speed it can
+// deliver. The motors hold commanded velocities on their own until the
+// battery cannot reach them, so commands are capped to what it can.
+class BatteryMonitor {
+private:
+    static constexpr double kMinSpeedFactor = 0.5;      // Never plan below half speed on a bad reading
+    static constexpr std::uint32_t kMaxStepMs = 100;    // Long gaps do not jump the filter
+
+    BatteryConfig config_;
+    double voltage_;
+    std::uint32_t last_ms_ = 0;
+    bool sampled_ = false;
+
+public:
+    explicit BatteryMonitor(const BatteryConfig& config = BatteryConfig())
+        : config_(config), voltage_(config.nominal_voltage) {}
+
+    void setConfig(const BatteryConfig& config) { config_ = config; }
+    const BatteryConfig& getConfig() const { return config_; }
+
+    // Read the battery once per tick
+    void sample(std::uint32_t now) {
+        if (sampled_ && now == last_ms_) return;
+
+        std::int32_t millivolts = pros::battery::get_voltage();
+        if (millivolts == PROS_ERR || millivolts <= 0) return;
+        double volts = millivolts / 1000.0;
+
+        if (!sampled_) {
+            voltage_ = volts;
+        } else {
+            double dt = std::min(now - last_ms_, kMaxStepMs);
+            voltage_ += (volts - voltage_) * dt / (config_.filter_ms + dt);
+        }
+        last_ms_ = now;
+        sampled_ = true;
+    }
+
+    // Filtered voltage, in volts; nominal until the first reading
+    double getVoltage() const { return voltage_; }
+
+    // Fraction of the nominal top speed the drive should command
+    double getSpeedFactor() const {
+        double usable = std::min(voltage_, config_.reference_voltage);
+        return std::clamp(usable / config_.nominal_voltage, kMinSpeedFactor, 1.0);
+    }
+};
+
+} // namespace movement
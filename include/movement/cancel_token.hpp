@@ -0,0 +1,31 @@
+#pragma once
+#include <atomic>
+#include <memory>
+
+namespace movement {
+
+// Shared stop request for a motion or macro. Copies share one flag, so any
+// holder can cancel from any task; the owner checks it once per tick.
+class CancelToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+
+public:
+    // A default token can never be cancelled
+    CancelToken() = default;
+
+    static CancelToken create() {
+        CancelToken token;
+        token.flag_ = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    void cancel() const {
+        if (flag_) *flag_ = true;
+    }
+
+    bool isCancelled() const { return flag_ && *flag_; }
+    bool canBeCancelled() const { return flag_ != nullptr; }
+};
+
+} // namespace movement
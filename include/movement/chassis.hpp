@@ -5,6 +5,17 @@
 #include "pros/imu.hpp"
 #include "pros/rotation.hpp"
 #include "core/subsystem.hpp"
+#include "movement/battery_monitor.hpp"
+#include "movement/cancel_token.hpp"
+#include "movement/gain_schedule.hpp"
+#include "movement/heading_service.hpp"
+#include "movement/motion_profile.hpp"
+#include "movement/odometry.hpp"
+#include "movement/output_shaper.hpp"
+#include "movement/power_manager.hpp"
+#include "movement/velocity_estimator.hpp"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -28,32 +39,89 @@ enum class OdomType {
     IMU_ENHANCED    // IMU-enhanced tracking
 };
 
+// How the drive comes to rest when a motion ends or is cancelled
+enum class StopBehavior : std::uint8_t {
+    COAST,  // Wheels spin down freely
+    BRAKE,  // Motors short their windings to stop quickly
+    HOLD    // Motors actively hold their position
+};
+
+// Side of the drive that stays locked in place during a swing turn
+enum class SwingSide : std::uint8_t {
+    LEFT,
+    RIGHT
+};
+
+// Why a motion ended
+enum class MotionResult : std::uint8_t {
+    RUNNING,        // Not finished yet
+    SETTLED,        // Error stayed within tolerance for settle_ms
+    STALLED,        // Wheels barely turning short of the target for stall_ms
+    TIMEOUT,        // Ran for timeout_ms
+    EARLY_EXIT,     // Reached the early exit range at min_speed; the next queued motion takes over at speed
+    CANCELLED       // Token cancelled, replaced by another motion, or the chassis was disabled
+};
+
+// A motion ends at the first condition met. Zero turns a time or speed check off.
+struct ExitConditions {
+    double move_tolerance = 1.0;        // Inches
+    double turn_tolerance = 0.05;       // Radians (~3 degrees)
+    std::uint32_t settle_ms = 0;        // Time the error must stay within tolerance
+    double stall_speed = 2.0;           // Wheel surface speed, in/s
+    std::uint32_t stall_ms = 300;
+    std::uint32_t timeout_ms = 5000;
+
+    // Motion chaining: never command less than min_speed (fraction of full
+    // speed) and end inside the early exit range, handing over to the next
+    // queued motion without stopping. Off while min_speed is zero.
+    double min_speed = 0.0;
+    double early_exit_range = 0.0;      // Inches; moves
+    double early_exit_angle = 0.0;      // Radians; turns, swings and arcs
+};
+
+// Per-motion settings shared by every motion type
+struct MotionOptions {
+    CancelToken token;                          // Checked every step; cancelling ends the motion
+    StopBehavior stop = StopBehavior::BRAKE;    // Applied when the motion ends and nothing is queued after it
+    ExitConditions exit;
+    ProfileLimits profile;                      // Swings and arcs
+    double blend_radius = 0.0;                  // Inches; from this far out a move aims past its
+                                                // point toward the next queued one and arcs onto it
+};
+
+// Options for a waypoint the robot drives through: it keeps at least
+// min_speed, hands over to the next queued motion range inches out, and
+// starts arcing toward it from twice that distance. Turns, swings and arcs
+// hand over turn_range radians short of their heading.
+inline MotionOptions chainedMotion(double min_speed = 0.4, double range = 6.0, MotionOptions options = {},
+                                   double turn_range = 0.15) {
+    options.exit.min_speed = min_speed;
+    options.exit.early_exit_range = range;
+    options.exit.early_exit_angle = turn_range;
+    options.blend_radius = 2.0 * range;
+    return options;
+}
+
+// Published on "motion_finished"
+struct MotionEvent {
+    std::uint32_t id;
+    MotionResult result;
+    std::uint32_t duration_ms;
+    double error;                   // Remaining error at the last step (inches or radians)
+};
+
 // Base configuration struct
 template<DriveType DT, OdomType OT>
 struct ChassisConfig {
     static constexpr DriveType driveType = DT;
     static constexpr OdomType odomType = OT;
-};
-
-// Position tracking class
-class Position {
-public:
-    double x;
-    double y;
-    double heading; // Radians
-
-    Position(double x = 0, double y = 0, double heading = 0)
-        : x(x), y(y), heading(heading) {}
 
-    double distanceTo(const field::Point& target) const {
-        double dx = target.x - x;
-        double dy = target.y - y;
-        return std::sqrt(dx*dx + dy*dy);
-    }
-
-    double angleTo(const field::Point& target) const {
-        return std::atan2(target.y - y, target.x - x);
-    }
+    // Drive geometry (inches); derived configs shadow these to match the robot
+    static constexpr double wheelDiameter = 3.25;
+    static constexpr double trackingWheelDiameter = 2.75;
+    static constexpr double trackWidth = 12.0;      // Left to right wheel centers
+    static constexpr double wheelBase = 12.0;       // Front to back wheel centers (holonomic drives)
+    static constexpr double gearRatio = 1.0;        // Wheel turns per motor turn
 };
 
 // Base chassis class
@@ -61,22 +129,407 @@ template<typename Config = ChassisConfig<DriveType::TANK, OdomType::NONE>>
 class Chassis : public core::ISubsystem {
 protected:
     std::string name_;
-    mutable Position current_pos_;
+    mutable Pose current_pos_;
+    mutable SlipDetector slip_detector_;
     std::vector<pros::Motor> motors_;
-    std::unique_ptr<pros::IMU> imu_;
+    mutable std::vector<MotorEncoder> encoders_;   // One per motor, same order
+    HeadingService heading_;
+    OutputShaper shaper_;                          // Slew and traction limits on every motor write
+    BatteryMonitor battery_;
+    PowerManager power_;                           // Thermal model and current limits
+    bool payload_ = false;                         // Carrying a game element; selects loaded gains
+    pros::MotorBrake brake_mode_ = pros::MotorBrake::coast;    // Restored after a motion's stop overrides it
+    bool brake_overridden_ = false;
     bool enabled_ = false;
 
+    // Background sensor bring-up
+    static constexpr std::uint32_t kCalibrationSettleMs = 100;   // Status bit lags reset()
+    static constexpr std::uint32_t kCalibrationTimeoutMs = 3000;
+    std::unique_ptr<pros::Task> sensor_task_;
+    std::atomic<bool> sensors_ready_{false};
+    std::atomic<bool> calibrating_{false};
+
+    // Calibration hooks run on the sensor task; derived chassis add their own sensors
+    virtual void beginSensorCalibration() { heading_.startCalibration(); }
+    virtual bool sensorsCalibrating() const { return heading_.isCalibrating(); }
+    // The cached bias goes in before tare(), which hands the IMUs back to the main task
+    virtual void finishSensorCalibration() {
+        heading_.loadBias(kBiasFilePath);
+        heading_.tare();
+    }
+
+    // IMU bias cache
+    static constexpr const char* kBiasFilePath = "/usd/imu_bias.bin";
+    static constexpr std::uint32_t kBiasSaveIntervalMs = 10000;
+    static constexpr double kStationaryVelocity = 1.0;           // RPM
+    std::uint32_t last_bias_save_ = 0;
+
+    bool isStationary() const {
+        sampleEncoders();
+        for (const auto& encoder : encoders_) {
+            if (std::abs(encoder.getRpm()) > kStationaryVelocity) return false;
+        }
+        return true;
+    }
+
+    // Encoder sampling, once per tick
+    mutable std::uint32_t encoder_sample_ms_ = 0;
+    mutable std::uint32_t encoder_timestamp_ = 0;  // Newest device timestamp, ms
+    mutable bool encoder_fresh_ = false;
+    mutable bool encoders_sampled_ = false;
+
+    // Read every drive encoder once per tick; true if any reported new data
+    bool sampleEncoders() const {
+        std::uint32_t now = pros::millis();
+        if (encoders_sampled_ && now == encoder_sample_ms_) return encoder_fresh_;
+
+        encoder_fresh_ = false;
+        for (size_t i = 0; i < motors_.size(); i++) {
+            if (encoders_[i].sample(motors_[i])) {
+                encoder_fresh_ = true;
+                encoder_timestamp_ = std::max(encoder_timestamp_, encoders_[i].getTimestamp());
+            }
+        }
+        encoder_sample_ms_ = now;
+        encoders_sampled_ = true;
+        return encoder_fresh_;
+    }
+
+    // Motor speed limit (green cartridge), RPM
+    static constexpr double kMaxRpm = 200.0;
+
+    // Wheel surface speed at kMaxRpm, in/s
+    static constexpr double topSpeed() {
+        return kMaxRpm / 60.0 * (Config::wheelDiameter * M_PI) * Config::gearRatio;
+    }
+
+    // Share of full speed the battery can deliver and hot motors can sustain
+    double speedFactor() const { return battery_.getSpeedFactor() * power_.getSpeedFactor(); }
+
+    // Motor speed available right now, RPM; commands are desaturated to it
+    double maxRpm() const { return kMaxRpm * speedFactor(); }
+
+    // Wheel surface speed available right now, in/s; profiles are planned within it
+    double availableSpeed() const { return topSpeed() * speedFactor(); }
+
+    // A gain at the current battery voltage and payload
+    double scheduled(const GainSchedule& gain) const {
+        return gain.get(battery_.getVoltage(), payload_);
+    }
+
+    // Active non-blocking motion, advanced one control step per tick
+    enum class MotionType : std::uint8_t {
+        NONE,
+        MOVE_TO,
+        TURN_TO,
+        ARC             // Constant radius to a heading; swings are arcs about one side
+    };
+
+    struct Motion {
+        MotionType type = MotionType::NONE;
+        field::Point target{0.0, 0.0};
+        double angle = 0.0;
+        bool reverse = false;
+        double radius = 0.0;                // ARC: path radius of the robot's center, inches
+        bool swing = false;                 // ARC: one side locked, see `locked`
+        SwingSide locked = SwingSide::LEFT;
+        MotionOptions options;
+        std::uint32_t id = 0;               // 0 is never a running motion
+        std::uint32_t start_ms = 0;
+        std::uint32_t last_step_ms = 0;
+        double error = 0.0;                 // From the last step
+        std::uint32_t settle_since = 0;     // Entered tolerance; valid while settling
+        std::uint32_t stall_since = 0;      // Dropped below stall_speed; valid while stalling
+        bool settling = false;
+        bool stalling = false;
+
+        // ARC plan, made on the first step so queued arcs start from where the robot really is
+        bool planned = false;
+        std::uint32_t plan_ms = 0;
+        double start_heading = 0.0;
+        double sweep = 0.0;                 // Signed heading change, radians
+        TrapezoidProfile profile;           // Along the center path
+    };
+    Motion motion_;
+    std::uint32_t next_motion_id_ = 1;
+
+    // Motions waiting to follow the active one; only non-empty while one is active
+    static constexpr size_t kMaxQueuedMotions = 16;
+    std::array<Motion, kMaxQueuedMotions> queue_{};
+    size_t queue_head_ = 0;
+    size_t queue_size_ = 0;
+
+    // Outcome of the most recent motion to end
+    std::uint32_t finished_id_ = 0;
+    MotionResult finished_result_ = MotionResult::CANCELLED;
+
+    // One control step toward the target, commanding at least min_speed
+    // (fraction of full speed); returns the remaining error, inches or radians
+    virtual double stepMoveTo(const field::Point& target, bool reverse, double min_speed) = 0;
+    virtual double stepTurnTo(double angle, double min_speed) = 0;
+
+    // Drive along a curve: center speed (in/s, negative backwards) and turn
+    // rate (rad/s, clockwise positive) as feedforward, plus the heading error
+    // (radians) to close on. With `swing` the locked side is held still.
+    virtual void driveCurve(double velocity, double yaw_rate, double heading_error,
+                            bool swing = false, SwingSide locked = SwingSide::LEFT) = 0;
+
+    // Curvature drive
+    static constexpr double kCurvatureAccel = 120.0;        // in/s^2
+    static constexpr double kCurvatureMaxError = 0.3;       // Radians the reference may lead or lag the robot
+    static constexpr std::uint32_t kCurvatureResetMs = 100; // A gap this long starts a fresh command
+
+    struct CurvatureState {
+        double velocity = 0.0;          // Ramped center speed, in/s
+        double heading = 0.0;           // Reference heading integrated from the commanded path
+        std::uint32_t last_ms = 0;
+        bool active = false;
+    };
+    CurvatureState curvature_;
+
+    // One profiled step of an arc; returns the remaining heading error
+    double stepArc(double min_speed) {
+        std::uint32_t now = pros::millis();
+        double heading = getPosition().heading;
+        double radius = std::max(motion_.radius, 1e-3);
+
+        if (!motion_.planned) {
+            motion_.planned = true;
+            motion_.plan_ms = now;
+            motion_.start_heading = heading;
+            motion_.sweep = wrapAngle(motion_.angle - heading);
+
+            // Keep the outer wheels within top speed and the acceleration limit
+            double outer = 1.0 + Config::trackWidth / (2.0 * radius);
+            const ProfileLimits& limits = motion_.options.profile;
+            motion_.profile = TrapezoidProfile(radius * std::abs(motion_.sweep),
+                                               limits.max_speed * availableSpeed() / outer,
+                                               limits.max_accel / outer);
+        }
+
+        double direction = motion_.sweep < 0.0 ? -1.0 : 1.0;
+        double t = (now - motion_.plan_ms) / 1000.0;
+        auto reference = motion_.profile.sample(t);
+
+        double speed = reference.velocity;
+        if (t < motion_.profile.duration()) speed = std::max(speed, min_speed * availableSpeed());
+
+        double target_heading = motion_.start_heading + motion_.sweep;
+        double reference_heading = motion_.start_heading + direction * reference.position / radius;
+        driveCurve(motion_.reverse ? -speed : speed, direction * speed / radius,
+                   reference_heading - heading, motion_.swing, motion_.locked);
+        return std::abs(target_heading - heading);
+    }
+
+    Motion arcMotion(double angle, double radius, bool reverse, const MotionOptions& options) const {
+        Motion motion;
+        motion.type = MotionType::ARC;
+        motion.angle = angle;
+        motion.radius = std::abs(radius);
+        motion.reverse = reverse;
+        motion.options = options;
+        return motion;
+    }
+
+    // A swing pivots on the locked wheels, so the center follows a circle of half the track width
+    Motion swingMotion(double angle, SwingSide locked, const MotionOptions& options) const {
+        Motion motion = arcMotion(angle, Config::trackWidth / 2.0, false, options);
+        motion.swing = true;
+        motion.locked = locked;
+        return motion;
+    }
+
+    // Latch tilt and slip for the shaper once per tick
+    void beginShapingTick() {
+        std::uint32_t now = pros::millis();
+        if (shaper_.hasTick(now)) return;
+        const OdometryQuality& quality = slip_detector_.getQuality();
+        shaper_.beginTick(now, heading_.getTilt(), quality.slipping, quality.speed_scale);
+    }
+
+    // Put back the configured brake mode once a stop's mode has done its job
+    void restoreBrakeMode() {
+        if (!brake_overridden_) return;
+        brake_overridden_ = false;
+        for (auto& motor : motors_) motor.set_brake_mode(brake_mode_);
+    }
+
+    // Every drive motor command goes through here, in RPM
+    void writeMotor(size_t index, double rpm) {
+        restoreBrakeMode();
+        beginShapingTick();
+        if (shaper_.isCoasting(index)) {
+            sampleEncoders();
+            shaper_.seed(index, encoders_[index].getRpm());
+        }
+        motors_[index].move_velocity(shaper_.apply(index, rpm));
+    }
+
+    // Keep ramping motors toward requests made on earlier ticks, so a single
+    // write (driver sticks, driveForward) still reaches its speed
+    void shapeOutputs() {
+        beginShapingTick();
+        for (size_t i = 0; i < motors_.size(); i++) {
+            double previous = shaper_.getOutput(i);
+            double output = shaper_.advance(i);
+            if (output != previous) motors_[i].move_velocity(output);
+        }
+    }
+
+    // Mean wheel surface speed from the drive encoders, in/s
+    double wheelSpeed() const {
+        sampleEncoders();
+        if (encoders_.empty()) return 0.0;
+
+        double rpm = 0.0;
+        for (const auto& encoder : encoders_) rpm += std::abs(encoder.getRpm());
+        rpm /= encoders_.size();
+        return rpm / 60.0 * (Config::wheelDiameter * M_PI) * Config::gearRatio;
+    }
+
+    // First exit condition met by the step just taken, or RUNNING
+    MotionResult checkExit(std::uint32_t now) {
+        const ExitConditions& exit = motion_.options.exit;
+        bool move = motion_.type == MotionType::MOVE_TO;
+        double tolerance = move ? exit.move_tolerance : exit.turn_tolerance;
+        double early_exit = move ? exit.early_exit_range : exit.early_exit_angle;
+
+        if (exit.min_speed > 0.0 && motion_.error < early_exit) return MotionResult::EARLY_EXIT;
+
+        if (motion_.error <= tolerance) {
+            if (!motion_.settling) motion_.settle_since = now;
+            motion_.settling = true;
+            motion_.stalling = false;
+            if (now - motion_.settle_since >= exit.settle_ms) return MotionResult::SETTLED;
+        } else {
+            motion_.settling = false;
+            if (exit.stall_ms > 0 && wheelSpeed() < exit.stall_speed) {
+                if (!motion_.stalling) motion_.stall_since = now;
+                motion_.stalling = true;
+                if (now - motion_.stall_since >= exit.stall_ms) return MotionResult::STALLED;
+            } else {
+                motion_.stalling = false;
+            }
+        }
+
+        if (exit.timeout_ms > 0 && now - motion_.start_ms >= exit.timeout_ms) return MotionResult::TIMEOUT;
+        return MotionResult::RUNNING;
+    }
+
+    // Motion that runs after the active one; null if the queue is empty
+    const Motion* nextQueued() const {
+        return queue_size_ > 0 ? &queue_[queue_head_] : nullptr;
+    }
+
+    // Whether motion id is still waiting in the queue
+    bool isQueued(std::uint32_t id) const {
+        for (size_t i = 0; i < queue_size_; i++) {
+            if (queue_[(queue_head_ + i) % kMaxQueuedMotions].id == id) return true;
+        }
+        return false;
+    }
+
+    // Make the next queued motion the active one; false if none is waiting
+    bool startNextQueued() {
+        if (queue_size_ == 0) return false;
+        motion_ = queue_[queue_head_];
+        motion_.start_ms = pros::millis();
+        queue_head_ = (queue_head_ + 1) % kMaxQueuedMotions;
+        queue_size_--;
+        return true;
+    }
+
+    // Point a move steers at this step. Within blend_radius of a waypoint
+    // followed by another move, the aim slides along the next leg so the robot
+    // arcs through the corner. The slide is capped at half the remaining
+    // distance, which keeps the robot closing on the waypoint until it hands over.
+    bool blendTarget(field::Point& aim) const {
+        const Motion* next = nextQueued();
+        if (motion_.options.blend_radius <= 0.0 || !next || next->type != MotionType::MOVE_TO) return false;
+
+        double distance = getPosition().distanceTo(motion_.target);
+        if (distance >= motion_.options.blend_radius) return false;
+
+        double dx = next->target.x - motion_.target.x;
+        double dy = next->target.y - motion_.target.y;
+        double leg = std::hypot(dx, dy);
+        if (leg < 1e-6) return false;
+
+        double slide = std::min({motion_.options.blend_radius - distance, distance / 2.0, leg});
+        aim = field::Point(motion_.target.x + dx / leg * slide, motion_.target.y + dy / leg * slide);
+        return true;
+    }
+
+    // Record how the active motion ended; the caller decides how to stop the drive
+    void finishMotion(MotionResult result) {
+        if (motion_.type == MotionType::NONE) return;
+        motion_.type = MotionType::NONE;
+        finished_id_ = motion_.id;
+        finished_result_ = result;
+
+        core::EventSystem::getInstance().emit("motion_finished",
+            MotionEvent{motion_.id, result, pros::millis() - motion_.start_ms, motion_.error});
+    }
+
+    std::uint32_t beginMotion(Motion motion) {
+        if (!enabled_) return 0;
+        finishMotion(MotionResult::CANCELLED);     // Replaced; the new motion takes the drive as is
+        queue_size_ = 0;
+        motion.id = next_motion_id_++;
+        motion.start_ms = pros::millis();
+        motion_ = motion;
+        return motion.id;
+    }
+
+    // Start now if nothing is running, otherwise run after what is already queued
+    std::uint32_t enqueueMotion(Motion motion) {
+        if (!isMotionActive()) return beginMotion(motion);
+        if (queue_size_ == kMaxQueuedMotions) return 0;
+
+        motion.id = next_motion_id_++;
+        queue_[(queue_head_ + queue_size_) % kMaxQueuedMotions] = motion;
+        queue_size_++;
+        return motion.id;
+    }
+
+    // Start every sensor calibrating at once and return immediately
+    void startSensorCalibration() {
+        if (calibrating_.exchange(true)) return; // Already running
+        sensors_ready_ = false;
+
+        sensor_task_ = std::make_unique<pros::Task>([this]() {
+            std::uint32_t start = pros::millis();
+            beginSensorCalibration();
+            pros::delay(kCalibrationSettleMs);
+            while (sensorsCalibrating() && pros::millis() - start < kCalibrationTimeoutMs) {
+                pros::delay(10);
+            }
+            finishSensorCalibration();
+            sensors_ready_ = true;
+            calibrating_ = false;
+        }, "chassis_sensors");
+    }
+
 public:
     explicit Chassis(const std::string& name = "chassis") 
-        : name_(name), current_pos_(), motors_(), imu_(nullptr) {}
+        : name_(name), current_pos_(), motors_(), heading_() {}
 
     virtual ~Chassis() override = default;
 
     // ISubsystem interface implementation
     virtual void initialize() override { enabled_ = true; }
-    virtual void update() override {}
+    virtual void enable() override { enabled_ = true; }
+    virtual void update() override {
+        battery_.sample(pros::millis());
+        power_.sample(pros::millis(), motors_);
+        refineHeadingBias();
+        stepMotion();
+        shapeOutputs();
+    }
     virtual void disable() override { 
         enabled_ = false;
+        finishMotion(MotionResult::CANCELLED);
+        queue_size_ = 0;
         stop(); 
     }
     virtual bool isEnabled() const override { return enabled_; }
@@ -84,12 +537,46 @@ public:
 
     virtual void initializeSensors(int imu_port, int left_enc_port = -1, int right_enc_port = -1) {
         if constexpr (Config::odomType == OdomType::IMU_ENHANCED || Config::odomType == OdomType::TRACKING) {
-            imu_ = std::make_unique<pros::IMU>(imu_port);
-            if (imu_) {
-                imu_->reset();
-                pros::delay(2000); // Wait for IMU calibration
+            if (imu_port > 0) {
+                heading_.addImu(imu_port);
             }
         }
+        startSensorCalibration();
+    }
+
+    // Refine the in-memory IMU bias while the robot is still; cheap enough for update()
+    void refineHeadingBias() {
+        if (!sensors_ready_) return;
+        heading_.refineBias(isStationary());
+    }
+
+    // Write the refined bias to the SD card now and then. SD writes can block
+    // for tens of milliseconds, so only call this from the disabled and
+    // pre-match loops, never from a control loop.
+    void saveHeadingBias() {
+        if (!sensors_ready_) return;
+        std::uint32_t now = pros::millis();
+        if (heading_.isBiasDirty() && now - last_bias_save_ > kBiasSaveIntervalMs) {
+            heading_.saveBias(kBiasFilePath);
+            last_bias_save_ = now;
+        }
+    }
+
+    // Sensor readiness
+    bool areSensorsReady() const { return sensors_ready_; }
+
+    // Block the calling task until calibration finishes; false on timeout
+    bool waitForSensors(std::uint32_t timeout_ms = kCalibrationTimeoutMs) const {
+        std::uint32_t start = pros::millis();
+        while (!sensors_ready_ && pros::millis() - start < timeout_ms) {
+            pros::delay(10);
+        }
+        return sensors_ready_;
+    }
+
+    // Additional IMUs are fused with the primary one by the heading service
+    virtual void addImu(int port) {
+        heading_.addImu(port);
     }
 
     // Motor management
@@ -100,33 +587,287 @@ public:
                 motor.set_reversed(true);
             }
             motors_.push_back(motor);
+            encoders_.emplace_back();
+            shaper_.resize(motors_.size());
         }
     }
 
-    // Direct motor control
+    // Direct motor control, in RPM; shaped like every other drive command
     virtual void setMotorVelocity(int index, double velocity) {
         if (index >= 0 && index < static_cast<int>(motors_.size())) {
-            motors_[index].move_velocity(velocity);
+            writeMotor(index, velocity);
+        }
+    }
+
+    // Output shaping limits (acceleration, anti-tip, traction control)
+    void setOutputShaping(const OutputShaperConfig& config) { shaper_.setConfig(config); }
+    const OutputShaper& getOutputShaper() const { return shaper_; }
+
+    // Battery compensation and gain scheduling inputs
+    void setBatteryConfig(const BatteryConfig& config) { battery_.setConfig(config); }
+    const BatteryMonitor& getBattery() const { return battery_; }
+    void setPayload(bool loaded) { payload_ = loaded; }
+    bool hasPayload() const { return payload_; }
+
+    // Drive motor temperature and current management
+    void setPowerConfig(const PowerConfig& config) { power_.setConfig(config); }
+    const PowerManager& getPowerManager() const { return power_; }
+
+    // Blocking motions for simple routines; they step the motion from the calling task.
+    // Another task can end them early through the options' token.
+    virtual MotionResult moveTo(const field::Point& target, bool reverse = false, const MotionOptions& options = {}) {
+        return waitForMotion(startMoveTo(target, reverse, options));
+    }
+
+    virtual MotionResult turnTo(double angle, const MotionOptions& options = {}) {
+        return waitForMotion(startTurnTo(angle, options));
+    }
+
+    MotionResult swingTo(double angle, SwingSide locked, const MotionOptions& options = {}) {
+        return waitForMotion(startSwingTo(angle, locked, options));
+    }
+
+    MotionResult arcTo(double angle, double radius, bool reverse = false, const MotionOptions& options = {}) {
+        return waitForMotion(startArcTo(angle, radius, reverse, options));
+    }
+
+    // Non-blocking motions, advanced by update(); each replaces the active one
+    // and clears the queue. Returns the motion id, or 0 if the chassis is disabled.
+    std::uint32_t startMoveTo(const field::Point& target, bool reverse = false, const MotionOptions& options = {}) {
+        Motion motion;
+        motion.type = MotionType::MOVE_TO;
+        motion.target = target;
+        motion.reverse = reverse;
+        motion.options = options;
+        return beginMotion(motion);
+    }
+
+    std::uint32_t startTurnTo(double angle, const MotionOptions& options = {}) {
+        Motion motion;
+        motion.type = MotionType::TURN_TO;
+        motion.angle = angle;
+        motion.options = options;
+        return beginMotion(motion);
+    }
+
+    // Turn to a heading with one side held still; the other side drives
+    // forwards or backwards depending on the direction of the turn
+    std::uint32_t startSwingTo(double angle, SwingSide locked, const MotionOptions& options = {}) {
+        return beginMotion(swingMotion(angle, locked, options));
+    }
+
+    // Drive a circle of `radius` inches (at the robot's center) until facing
+    // `angle`; the turn direction is the shorter way round
+    std::uint32_t startArcTo(double angle, double radius, bool reverse = false, const MotionOptions& options = {}) {
+        return beginMotion(arcMotion(angle, radius, reverse, options));
+    }
+
+    // Queued motions start the step after the one before them ends, without
+    // stopping in between. Returns the motion id, or 0 if disabled or the queue is full.
+    std::uint32_t queueMoveTo(const field::Point& target, bool reverse = false, const MotionOptions& options = {}) {
+        Motion motion;
+        motion.type = MotionType::MOVE_TO;
+        motion.target = target;
+        motion.reverse = reverse;
+        motion.options = options;
+        return enqueueMotion(motion);
+    }
+
+    std::uint32_t queueTurnTo(double angle, const MotionOptions& options = {}) {
+        Motion motion;
+        motion.type = MotionType::TURN_TO;
+        motion.angle = angle;
+        motion.options = options;
+        return enqueueMotion(motion);
+    }
+
+    std::uint32_t queueSwingTo(double angle, SwingSide locked, const MotionOptions& options = {}) {
+        return enqueueMotion(swingMotion(angle, locked, options));
+    }
+
+    std::uint32_t queueArcTo(double angle, double radius, bool reverse = false, const MotionOptions& options = {}) {
+        return enqueueMotion(arcMotion(angle, radius, reverse, options));
+    }
+
+    // Drive through every point without stopping, ending at the last with
+    // `options`; returns the last motion's id, or 0 if the path does not fit the queue
+    std::uint32_t followPath(const std::vector<field::Point>& points, bool reverse = false,
+                             const MotionOptions& options = {}, double carry_speed = 0.4) {
+        size_t starts_now = isMotionActive() || points.empty() ? 0 : 1;
+        if (points.size() - starts_now > kMaxQueuedMotions - queue_size_) return 0;
+
+        std::uint32_t id = 0;
+        for (size_t i = 0; i < points.size(); i++) {
+            bool last = i + 1 == points.size();
+            id = queueMoveTo(points[i], reverse, last ? options : chainedMotion(carry_speed, 6.0, options));
+            if (id == 0) return 0;
+        }
+        return id;
+    }
+
+    // Advance the active motion by one step (at most once per ms); false once none is running
+    bool stepMotion() {
+        if (motion_.type == MotionType::NONE) return false;
+        if (!enabled_ || motion_.options.token.isCancelled()) {
+            cancelMotion();
+            return false;
         }
+
+        std::uint32_t now = pros::millis();
+        if (now == motion_.last_step_ms) return true;
+        motion_.last_step_ms = now;
+
+        double min_speed = motion_.options.exit.min_speed;
+        if (motion_.type == MotionType::MOVE_TO) {
+            field::Point aim = motion_.target;
+            bool blended = blendTarget(aim);
+            motion_.error = stepMoveTo(aim, motion_.reverse, min_speed);
+            if (blended) motion_.error = getPosition().distanceTo(motion_.target);
+        } else if (motion_.type == MotionType::TURN_TO) {
+            motion_.error = stepTurnTo(motion_.angle, min_speed);
+        } else {
+            motion_.error = stepArc(min_speed);
+        }
+
+        MotionResult result = checkExit(now);
+        if (result == MotionResult::RUNNING) return true;
+        finishMotion(result);
+
+        // The next queued motion takes over in this same step
+        if (startNextQueued()) return stepMotion();
+        stop(motion_.options.stop);
+        return false;
+    }
+
+    // Step the given motion (and anything queued before it) from the calling task until it ends
+    MotionResult waitForMotion(std::uint32_t id) {
+        while (getMotionResult(id) == MotionResult::RUNNING) {
+            stepMotion();
+            pros::delay(10);
+        }
+        return getMotionResult(id);
+    }
+
+    // End the active motion now, stopping the way it was started with
+    void cancelMotion() {
+        cancelMotion(motion_.options.stop);
+    }
+
+    // Also drops everything queued
+    void cancelMotion(StopBehavior behavior) {
+        if (motion_.type == MotionType::NONE) return;
+        finishMotion(MotionResult::CANCELLED);
+        queue_size_ = 0;
+        stop(behavior);
     }
 
-    // Required movement interface
-    virtual void moveTo(const field::Point& target, bool reverse = false) = 0;
-    virtual void turnTo(double angle) = 0;
+    bool isMotionActive() const { return motion_.type != MotionType::NONE; }
+    std::uint32_t getMotionId() const { return isMotionActive() ? motion_.id : 0; }
+
+    // RUNNING while the motion is active or queued; how it ended if it was the
+    // last to end; CANCELLED for older or unknown ids (including 0, never started)
+    MotionResult getMotionResult(std::uint32_t id) const {
+        if (id != 0 && (id == getMotionId() || isQueued(id))) return MotionResult::RUNNING;
+        if (id != 0 && id == finished_id_) return finished_result_;
+        return MotionResult::CANCELLED;
+    }
+
+    // Open-loop drive in the robot's frame, each a fraction of full speed:
+    // forward, strafe (right positive) and turn (clockwise positive). Drives
+    // that cannot strafe ignore it. Wheels are scaled down together when the
+    // sum saturates.
+    virtual void drive(double forward, double strafe, double turn) = 0;
+
+    // Drive at `throttle` (fraction of top speed, negative backwards) along a
+    // path of `curvature` (1/inches, positive curves clockwise). The turn rate
+    // scales with speed, so the path is the same at any throttle. Call every tick.
+    virtual void curvatureDrive(double throttle, double curvature) {
+        std::uint32_t now = pros::millis();
+        double heading = getPosition().heading;
+        if (!curvature_.active || now - curvature_.last_ms > kCurvatureResetMs) {
+            curvature_ = CurvatureState{0.0, heading, now, true};
+        }
+        double dt = (now - curvature_.last_ms) / 1000.0;
+        curvature_.last_ms = now;
+
+        // Ramp toward the requested speed instead of stepping to it
+        double target = std::clamp(throttle, -1.0, 1.0) * availableSpeed();
+        double step = kCurvatureAccel * dt;
+        curvature_.velocity += std::clamp(target - curvature_.velocity, -step, step);
+
+        // The reference heading follows the commanded path and the heading sensor
+        // closes on it; it never runs far ahead of a robot that is held up
+        double yaw_rate = curvature_.velocity * curvature;
+        curvature_.heading += yaw_rate * dt;
+        curvature_.heading = heading + std::clamp(curvature_.heading - heading, -kCurvatureMaxError, kCurvatureMaxError);
+
+        driveCurve(curvature_.velocity, yaw_rate, curvature_.heading - heading, false, SwingSide::LEFT);
+    }
+
+    // Stops bypass the output shaper and take effect at once
     virtual void stop() {
+        restoreBrakeMode();
+        shaper_.reset();
         for (auto& motor : motors_) {
             motor.move_velocity(0);
         }
     }
 
+    // Stop with a given brake mode. The mode stays set until the next command,
+    // which puts back the configured one (setBrakeMode).
+    virtual void stop(StopBehavior behavior) {
+        pros::MotorBrake mode = pros::MotorBrake::brake;
+        if (behavior == StopBehavior::COAST) mode = pros::MotorBrake::coast;
+        if (behavior == StopBehavior::HOLD) mode = pros::MotorBrake::hold;
+
+        // A coasting robot is still moving; the next command ramps down from its measured speed
+        if (behavior == StopBehavior::COAST) {
+            shaper_.coast();
+        } else {
+            shaper_.reset();
+        }
+        brake_overridden_ = true;
+        for (auto& motor : motors_) {
+            motor.set_brake_mode(mode);
+            motor.brake();
+        }
+    }
+
+    // Brake mode for driver control and open-loop commands; PROS defaults to coast
+    void setBrakeMode(pros::MotorBrake mode) {
+        brake_mode_ = mode;
+        brake_overridden_ = true;
+        restoreBrakeMode();
+    }
+    pros::MotorBrake getBrakeMode() const { return brake_mode_; }
+
     // Position tracking
     virtual Position getPosition() const { return current_pos_; }
+    virtual Pose getPose() const { getPosition(); return current_pos_; }
+    const OdometryQuality& getOdometryQuality() const { return slip_detector_.getQuality(); }
+
+    // Place the robot on the field; heading in radians
+    virtual void setPosition(const Position& position) {
+        current_pos_ = Pose(position);
+        heading_.tare(position.heading);
+        slip_detector_.reset();
+    }
+
+    // Heading tracking (radians, unwrapped)
+    double getHeading() const { return heading_.getHeading(); }
+    HeadingService& getHeadingService() { return heading_; }
 
     // Accessors
     size_t getMotorCount() const { return motors_.size(); }
     const pros::Motor& getMotor(int index) const { 
         return motors_.at(index);
     }
+
+    // Motor speed from the timestamped encoder estimator, in RPM
+    double getMotorRpm(int index) const {
+        sampleEncoders();
+        return encoders_.at(index).getRpm();
+    }
 };
 
 } // namespace movement
@@ -2,6 +2,10 @@
 #include "main.h"
 #include "movement/chassis.hpp"
 #include "movement/driver_control.hpp"
+#include "movement/action_graph.hpp"
+#include "movement/controller_state.hpp"
+#include "movement/macro_task.hpp"
+#include "movement/sequence_matcher.hpp"
 #include "pros/misc.hpp"
 #include "core/subsystem.hpp"
 #include <functional>
@@ -21,22 +25,16 @@ class MacroSystem;
 template<typename ChassisConfig>
 class InputMapper;
 
-// Base macro interface
-class Macro {
-public:
-    virtual ~Macro() = default;
-    virtual void execute() = 0;
-    virtual bool isComplete() const = 0;
-    virtual void reset() = 0;
-};
-
 // Input binding types
-enum class InputType {
-    BUTTON,
-    BUTTON_COMBO,
+enum class InputType : std::uint8_t {
+    BUTTON,         // All buttons held, fires on the tick one of them is pressed
+    BUTTON_COMBO,   // Fires every tick while all buttons are held
     ANALOG_ABOVE,
     ANALOG_BELOW,
-    SEQUENCE
+    SEQUENCE,
+    RELEASE,        // Fires on the tick the held buttons are let go
+    HOLD,           // Fires once after the buttons are held for hold_time
+    DOUBLE_TAP      // Fires on a second press within double_tap_window
 };
 
 // Input binding structure
@@ -46,135 +44,304 @@ struct InputBinding {
     pros::controller_analog_e_t analog = ANALOG_LEFT_Y;
     double threshold = 0.0;
     std::chrono::milliseconds sequence_window{500};
+    std::chrono::milliseconds hold_time{500};
+    std::chrono::milliseconds double_tap_window{300};
+    int controller = 0;             // Primary = 0, Partner = 1
 };
 
-// Input mapper class
-template<typename ChassisConfig>
-class InputMapper : public core::ISubsystem {
-private:
-    std::string name_;
-    pros::Controller& controller_;
-    std::unordered_map<std::string, InputBinding> bindings_;
-    std::unordered_map<std::string, std::function<void()>> actions_;
-    std::vector<std::pair<std::chrono::steady_clock::time_point, std::string>> input_history_;
-    bool enabled_ = false;
-    
-    bool checkBinding(const InputBinding& binding) {
+// Binding compiled at registration into a compact state machine over the button mask
+struct CompiledBinding {
+    // Machine states for HOLD and DOUBLE_TAP
+    enum State : std::uint8_t {
+        IDLE,
+        ARMED,      // HOLD: waiting for hold_time, DOUBLE_TAP: waiting for the second press
+        FIRED       // HOLD: waiting for release
+    };
+
+    InputType type;
+    State state = IDLE;
+    std::uint8_t analog = 0;
+    std::uint8_t controller = 0;
+    std::uint16_t mask = 0;
+    std::uint16_t action = 0;       // Index into InputMapper::actions_
+    float threshold = 0.0f;
+    std::uint32_t window_ms = 0;    // hold_time, double_tap_window or sequence_window
+    std::uint32_t timer = 0;        // Time the machine entered ARMED
+
+    static CompiledBinding compile(const InputBinding& binding, std::uint16_t action) {
+        CompiledBinding compiled;
+        compiled.type = binding.type;
+        compiled.analog = static_cast<std::uint8_t>(binding.analog);
+        compiled.controller = binding.controller == 1 ? 1 : 0;
+        compiled.action = action;
+        compiled.threshold = static_cast<float>(binding.threshold);
+        for (auto btn : binding.buttons) compiled.mask |= buttonBit(btn);
+
         switch (binding.type) {
+            case InputType::HOLD:       compiled.window_ms = binding.hold_time.count(); break;
+            case InputType::DOUBLE_TAP: compiled.window_ms = binding.double_tap_window.count(); break;
+            case InputType::SEQUENCE:   compiled.window_ms = binding.sequence_window.count(); break;
+            default: break;
+        }
+        return compiled;
+    }
+
+    // Advance the machine by one snapshot; true when the action should run
+    bool step(const ControllerSnapshot& input) {
+        bool held = input.held(mask);
+        bool pressed = held && (input.pressed() & mask);
+
+        switch (type) {
             case InputType::BUTTON:
-                return !binding.buttons.empty() && 
-                       controller_.get_digital_new_press(binding.buttons[0]); // Changed to new_press
-                
-            case InputType::BUTTON_COMBO: {
-                return std::all_of(binding.buttons.begin(), binding.buttons.end(),
-                    [this](auto btn) { return controller_.get_digital(btn); });
-            }
-            
+                return mask && pressed;
+
+            case InputType::BUTTON_COMBO:
+                return mask && held;
+
+            case InputType::RELEASE:
+                return mask && (input.previous & mask) == mask && !held;
+
             case InputType::ANALOG_ABOVE:
-                return (controller_.get_analog(binding.analog) / 127.0) > binding.threshold;
-                
+                return input.axes[analog] / 127.0f > threshold;
+
             case InputType::ANALOG_BELOW:
-                return (controller_.get_analog(binding.analog) / 127.0) < binding.threshold;
-                
-            case InputType::SEQUENCE: {
-                auto now = std::chrono::steady_clock::now();
-                
-                // Clean old inputs
-                input_history_.erase(
-                    std::remove_if(input_history_.begin(), input_history_.end(),
-                        [&](const auto& entry) {
-                            return now - entry.first > binding.sequence_window;
-                        }),
-                    input_history_.end()
-                );
-
-                // Check sequence
-                if (input_history_.size() == binding.buttons.size()) {
-                    bool matches = true;
-                    for (size_t i = 0; i < binding.buttons.size(); i++) {
-                        if (controller_.get_digital(binding.buttons[i]) != 
-                            controller_.get_digital(binding.buttons[i])) {
-                            matches = false;
-                            break;
-                        }
-                    }
-                    if (matches) {
-                        input_history_.clear();
-                        return true;
-                    }
+                return input.axes[analog] / 127.0f < threshold;
+
+            case InputType::HOLD:
+                if (!held) {
+                    state = IDLE;
+                } else if (state == IDLE) {
+                    state = ARMED;
+                    timer = input.timestamp;
+                } else if (state == ARMED && input.timestamp - timer >= window_ms) {
+                    state = FIRED;
+                    return true;
                 }
+                return false;
 
-                // Record new input
-                for (auto btn : binding.buttons) {
-                    if (controller_.get_digital_new_press(btn)) {
-                        input_history_.emplace_back(now, std::to_string(static_cast<int>(btn)));
-                        break;
-                    }
+            case InputType::DOUBLE_TAP:
+                if (state == ARMED && input.timestamp - timer > window_ms) {
+                    state = IDLE;
+                }
+                if (!pressed) return false;
+                if (state == ARMED) {
+                    state = IDLE;
+                    return true;
                 }
+                state = ARMED;
+                timer = input.timestamp;
                 return false;
-            }
+
+            case InputType::SEQUENCE:
+                return false; // Matched for all bindings at once by SequenceMatcher
         }
         return false;
     }
+};
+
+// Input mapper class
+template<typename ChassisConfig>
+class InputMapper : public core::ISubsystem {
+private:
+    std::string name_;
+    const ControllerState* inputs_[2];  // Master, partner (null when there is none)
+
+    // Compiled bindings, stored contiguously; actions_, names_ and sources_ share their order
+    std::vector<CompiledBinding> bindings_;
+    std::vector<std::function<void()>> actions_;
+    std::vector<std::string> names_;
+    std::vector<InputBinding> sources_;
+
+    SequenceMatcher sequences_[2];      // Every SEQUENCE binding per controller, matched in one pass
+    std::uint16_t master_mask_ = 0;     // Buttons used by master bindings
+    std::uint32_t last_sequence_ = 0;   // Master snapshot already evaluated
+    bool enabled_ = false;
+
+    // Sequence ids are binding indices, so rebuild whenever indices move
+    void rebuild() {
+        sequences_[0].clear();
+        sequences_[1].clear();
+        master_mask_ = 0;
+        for (size_t i = 0; i < sources_.size(); i++) {
+            const auto& binding = bindings_[i];
+            if (binding.controller == 0) master_mask_ |= binding.mask;
+            if (sources_[i].type == InputType::SEQUENCE) {
+                sequences_[binding.controller].addSequence(sources_[i].buttons, binding.window_ms, static_cast<int>(i));
+            }
+        }
+    }
+
+    // Partner bindings move to the master while the partner is disconnected,
+    // except those sharing a button with a master binding, which stay quiet
+    bool runsOn(const CompiledBinding& binding, int controller, bool fallback) const {
+        if (binding.controller == controller) return true;
+        return fallback && controller == 0 && (binding.mask & master_mask_) == 0;
+    }
+
+    void evaluate(int controller, const ControllerSnapshot& input, bool fallback) {
+        int sequence = sequences_[controller].update(input);
+        if (sequence >= 0) {
+            actions_[bindings_[sequence].action]();
+        }
+        if (fallback) {
+            sequence = sequences_[1].update(input);
+            if (sequence >= 0 && (bindings_[sequence].mask & master_mask_) == 0) {
+                actions_[bindings_[sequence].action]();
+            }
+        }
+
+        for (auto& binding : bindings_) {
+            if (runsOn(binding, controller, fallback) && binding.step(input)) {
+                actions_[binding.action]();
+            }
+        }
+    }
+
+    int findBinding(const std::string& name) const {
+        for (size_t i = 0; i < names_.size(); i++) {
+            if (names_[i] == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
 
 public:
-    InputMapper(const std::string& name, pros::Controller& controller) 
-        : name_(name), controller_(controller) {}
+    InputMapper(const std::string& name, const ControllerState& input) 
+        : name_(name), inputs_{&input, nullptr} {}
+
+    // Routes each binding to the controller named by InputBinding::controller
+    InputMapper(const std::string& name, const ControllerState& master, const ControllerState& partner)
+        : name_(name), inputs_{&master, &partner} {}
 
     // ISubsystem interface implementation
     void initialize() override { enabled_ = true; }
+    void enable() override { enabled_ = true; }
     void update() override {
         if (!enabled_) return;
-        
-        for (const auto& [name, binding] : bindings_) {
-            if (checkBinding(binding)) {
-                if (auto it = actions_.find(name); it != actions_.end()) {
-                    it->second();
-                }
-            }
-        }
+
+        // Evaluate each snapshot once, even if update() is reached from more than one owner
+        const auto& master = inputs_[0]->get();
+        if (master.sequence == last_sequence_) return;
+        last_sequence_ = master.sequence;
+
+        bool partner = inputs_[1] && inputs_[1]->get().connected;
+        evaluate(0, master, !partner);
+        if (partner) evaluate(1, inputs_[1]->get(), false);
     }
     void disable() override { enabled_ = false; }
     bool isEnabled() const override { return enabled_; }
     const std::string& getName() const override { return name_; }
 
+    // Bindings are compiled here, so nothing is parsed or looked up by name per tick
     void addBinding(const std::string& name, const InputBinding& binding, 
                    std::function<void()> action) {
-        bindings_[name] = binding;
-        actions_[name] = std::move(action);
+        int existing = findBinding(name);
+        size_t index = existing >= 0 ? existing : bindings_.size();
+        auto compiled = CompiledBinding::compile(binding, static_cast<std::uint16_t>(index));
+
+        if (existing >= 0) {
+            bindings_[index] = compiled;
+            actions_[index] = std::move(action);
+            sources_[index] = binding;
+        } else {
+            bindings_.push_back(compiled);
+            actions_.push_back(std::move(action));
+            names_.push_back(name);
+            sources_.push_back(binding);
+        }
+        rebuild();
     }
 
     void removeBinding(const std::string& name) {
-        bindings_.erase(name);
-        actions_.erase(name);
+        int index = findBinding(name);
+        if (index < 0) return;
+
+        // Swap with the last binding to keep storage contiguous
+        size_t last = bindings_.size() - 1;
+        if (static_cast<size_t>(index) != last) {
+            bindings_[index] = bindings_[last];
+            bindings_[index].action = static_cast<std::uint16_t>(index);
+            actions_[index] = std::move(actions_[last]);
+            names_[index] = std::move(names_[last]);
+            sources_[index] = std::move(sources_[last]);
+        }
+        bindings_.pop_back();
+        actions_.pop_back();
+        names_.pop_back();
+        sources_.pop_back();
+        rebuild();
     }
+
+    size_t getBindingCount() const { return bindings_.size(); }
 };
 
-// Macro system class
+// Macro system class. Any number of macros run side by side; starting one
+// interrupts the running macros that need any of the same resources.
 template<typename ChassisConfig>
 class MacroSystem : public core::ISubsystem {
 private:
+    struct ActiveMacro {
+        std::string name;
+        Macro* macro;
+        CancelToken token;      // Checked before every step
+        bool running;
+    };
+
     std::string name_;
     Chassis<ChassisConfig>& chassis_;
     std::unordered_map<std::string, std::unique_ptr<Macro>> macros_;
-    std::string active_macro_;
+    std::vector<ActiveMacro> active_;
+    std::uint32_t last_update_ms_ = 0;  // Macros advance at most once per tick
+    bool updating_ = false;             // Entries are only erased outside the update loop
     bool enabled_ = false;
 
+    void cancel(ActiveMacro& entry) {
+        if (!entry.running) return;
+        entry.running = false;
+        entry.macro->cancel();
+    }
+
+    void prune() {
+        if (updating_) return;
+        active_.erase(std::remove_if(active_.begin(), active_.end(),
+                                     [](const ActiveMacro& entry) { return !entry.running; }),
+                      active_.end());
+    }
+
+    ActiveMacro* findActive(const std::string& name) {
+        for (auto& entry : active_) {
+            if (entry.running && entry.name == name) return &entry;
+        }
+        return nullptr;
+    }
+
 public:
     MacroSystem(const std::string& name, Chassis<ChassisConfig>& chassis) 
         : name_(name), chassis_(chassis) {}
 
     // ISubsystem interface implementation
     void initialize() override { enabled_ = true; }
+    void enable() override { enabled_ = true; }
     void update() override {
-        if (!enabled_ || active_macro_.empty()) return;
-        
-        if (auto it = macros_.find(active_macro_); it != macros_.end()) {
-            it->second->execute();
-            if (it->second->isComplete()) {
-                stopMacro();
+        if (!enabled_ || active_.empty()) return;
+
+        std::uint32_t now = pros::millis();
+        if (now == last_update_ms_) return;
+        last_update_ms_ = now;
+
+        // Macros started during this loop are appended and first run next tick
+        updating_ = true;
+        size_t count = active_.size();
+        for (size_t i = 0; i < count; i++) {
+            if (!active_[i].running) continue;
+            if (active_[i].token.isCancelled()) {
+                cancel(active_[i]);
+                continue;
             }
+            active_[i].macro->execute();
+            if (active_[i].macro->isComplete()) active_[i].running = false;
         }
+        updating_ = false;
+        prune();
     }
     void disable() override { 
         enabled_ = false;
@@ -184,26 +351,56 @@ public:
     const std::string& getName() const override { return name_; }
 
     void registerMacro(const std::string& name, std::unique_ptr<Macro> macro) {
+        stopMacro(name);
         macros_[name] = std::move(macro);
     }
 
-    bool startMacro(const std::string& name) {
-        if (!enabled_) return false;
-        
-        if (auto it = macros_.find(name); it != macros_.end() && active_macro_.empty()) {
-            active_macro_ = name;
-            it->second->reset();
-            return true;
+    // Start a macro, interrupting whatever holds its resources; false if it is
+    // unknown, already running, or the system is disabled. Cancelling the token,
+    // from any task, stops the macro on its next tick.
+    bool startMacro(const std::string& name, CancelToken token = {}) {
+        if (!enabled_ || findActive(name)) return false;
+
+        auto it = macros_.find(name);
+        if (it == macros_.end()) return false;
+
+        interrupt(it->second->requirements());
+        it->second->reset();
+        active_.push_back(ActiveMacro{name, it->second.get(), std::move(token), true});
+        return true;
+    }
+
+    // Stop every running macro that needs any of the given resources
+    void interrupt(std::uint32_t resources) {
+        for (auto& entry : active_) {
+            if (entry.running && (entry.macro->requirements() & resources)) cancel(entry);
         }
-        return false;
+        prune();
     }
 
+    // Stop every running macro
     void stopMacro() {
-        active_macro_.clear();
+        for (auto& entry : active_) cancel(entry);
+        prune();
+    }
+
+    void stopMacro(const std::string& name) {
+        if (auto entry = findActive(name)) cancel(*entry);
+        prune();
     }
 
     bool isMacroActive() const {
-        return !active_macro_.empty();
+        for (const auto& entry : active_) {
+            if (entry.running) return true;
+        }
+        return false;
+    }
+
+    bool isMacroActive(const std::string& name) const {
+        for (const auto& entry : active_) {
+            if (entry.running && entry.name == name) return true;
+        }
+        return false;
     }
 
     Chassis<ChassisConfig>& getChassis() { return chassis_; }
@@ -213,11 +410,13 @@ public:
 class MovementMacro : public Macro {
 private:
     std::function<void()> movement_func_;
+    std::uint32_t requirements_;
     bool complete_ = false;
 
 public:
-    explicit MovementMacro(std::function<void()> func) 
-        : movement_func_(std::move(func)) {}
+    explicit MovementMacro(std::function<void()> func, std::uint32_t requirements = RESOURCE_CHASSIS) 
+        : movement_func_(std::move(func))
+        , requirements_(requirements) {}
 
     void execute() override {
         if (!complete_) {
@@ -233,6 +432,28 @@ public:
     void reset() override {
         complete_ = false;
     }
+
+    std::uint32_t requirements() const override { return requirements_; }
+};
+
+// Macro that runs a coroutine, resuming it once per tick until it returns.
+// The factory is called on every start, so the macro can be run again.
+class CoroutineMacro : public Macro {
+private:
+    std::function<MacroTask()> factory_;
+    MacroTask task_;
+    std::uint32_t requirements_;
+
+public:
+    explicit CoroutineMacro(std::function<MacroTask()> factory, std::uint32_t requirements = RESOURCE_CHASSIS)
+        : factory_(std::move(factory))
+        , requirements_(requirements) {}
+
+    void execute() override { task_.resume(); }
+    bool isComplete() const override { return task_.done(); }
+    void reset() override { task_ = factory_(); }
+    void cancel() override { task_.reset(); }
+    std::uint32_t requirements() const override { return requirements_; }
 };
 
 // Enhanced driver control
@@ -257,6 +478,7 @@ public:
 
     // ISubsystem interface implementation
     void initialize() override { enabled_ = true; }
+    void enable() override { enabled_ = true; }
     void update() override {
         if (!enabled_) return;
         
@@ -0,0 +1,131 @@
+#pragma once
+#include "main.h"
+#include "pros/misc.hpp"
+#include "core/subsystem.hpp"
+#include "movement/controller_state.hpp"
+#include "movement/input_recording.hpp"
+#include <cstdint>
+#include <cstdlib>
+
+namespace movement {
+
+// Controller ids, as used by DriverConfig::controller_id and InputBinding::controller
+constexpr int kMasterController = 0;
+constexpr int kPartnerController = 1;
+
+// Drive arbitration rules
+struct ControllerArbitration {
+    int priority = kMasterController;   // Wins whenever its sticks are active
+    int stick_threshold = 12;           // Raw stick value that counts as active
+    std::uint32_t handback_ms = 300;         // Priority sticks must rest this long before the other controller drives
+};
+
+// Picks which controller's sticks drive the chassis each tick
+class DriveArbiter : public ControllerSource {
+private:
+    const ControllerState* inputs_[2];
+    ControllerArbitration rules_;
+    int owner_;
+    std::uint32_t priority_active_ms_ = 0;   // Last tick the priority controller moved a stick
+
+    bool sticksActive(const ControllerSnapshot& snapshot) const {
+        if (!snapshot.connected) return false;
+        for (auto axis : snapshot.axes) {
+            if (std::abs(axis) >= rules_.stick_threshold) return true;
+        }
+        return false;
+    }
+
+public:
+    DriveArbiter(const ControllerState& master, const ControllerState& partner)
+        : inputs_{&master, &partner}
+        , owner_(rules_.priority) {}
+
+    void setRules(const ControllerArbitration& rules) {
+        rules_ = rules;
+        owner_ = rules_.priority;
+    }
+
+    const ControllerArbitration& getRules() const { return rules_; }
+    int getOwner() const { return owner_; }
+
+    bool read(ControllerSnapshot& frame) override {
+        int priority = rules_.priority;
+        int other = 1 - priority;
+        const auto& first = inputs_[priority]->get();
+        const auto& second = inputs_[other]->get();
+        int previous_owner = owner_;
+
+        if (sticksActive(first)) {
+            priority_active_ms_ = frame.timestamp;
+            owner_ = priority;                                      // Priority always overrides
+        } else if (!first.connected) {
+            owner_ = other;                                         // Fallback when priority drops out
+        } else if (owner_ == priority && sticksActive(second) &&
+                   frame.timestamp - priority_active_ms_ >= rules_.handback_ms) {
+            owner_ = other;
+        } else if (owner_ == other && (!second.connected || !sticksActive(second))) {
+            owner_ = priority;
+        }
+
+        if (owner_ != previous_owner) {
+            core::EventSystem::getInstance().emit("drive_owner_changed", owner_);
+        }
+
+        const auto& source = inputs_[owner_]->get();
+        frame.buttons = source.buttons;
+        frame.axes = source.axes;
+        frame.connected = source.connected;
+        return true;
+    }
+};
+
+// Samples the master and partner controllers once per tick and exposes the
+// arbitrated drive input alongside each controller's own snapshot
+class ControllerManager {
+private:
+    pros::Controller master_{pros::E_CONTROLLER_MASTER};
+    pros::Controller partner_{pros::E_CONTROLLER_PARTNER};
+    ControllerState master_state_{master_};
+    ControllerState partner_state_{partner_};
+    DriveArbiter arbiter_{master_state_, partner_state_};
+    ControllerState drive_state_{master_};      // Always fed by arbiter_
+    InputRecorder* recorder_ = nullptr;         // Sees both controllers every tick while set
+
+public:
+    ControllerManager() {
+        drive_state_.setSource(&arbiter_);
+    }
+
+    ControllerManager(const ControllerManager&) = delete;
+    ControllerManager& operator=(const ControllerManager&) = delete;
+
+    // Call exactly once per tick before any consumer updates
+    void sample() {
+        master_state_.sample();
+        partner_state_.sample();
+        drive_state_.sample();
+        if (recorder_) recorder_->write(master_state_.get(), partner_state_.get());
+    }
+
+    // Record both controllers each tick (nullptr to stop)
+    void setRecorder(InputRecorder* recorder) { recorder_ = recorder; }
+
+    ControllerState& getMaster() { return master_state_; }
+    ControllerState& getPartner() { return partner_state_; }
+    const ControllerState& get(int id) const {
+        return id == kPartnerController ? partner_state_ : master_state_;
+    }
+
+    // Input for DriverControl; see DriveArbiter for the rules
+    const ControllerState& getDrive() const { return drive_state_; }
+    int getDriveOwner() const { return arbiter_.getOwner(); }
+    void setArbitration(const ControllerArbitration& rules) { arbiter_.setRules(rules); }
+
+    bool isPartnerConnected() const { return partner_state_.get().connected; }
+    pros::Controller& getController(int id) {
+        return id == kPartnerController ? partner_ : master_;
+    }
+};
+
+} // namespace movement
@@ -0,0 +1,110 @@
+#pragma once
+#include "main.h"
+#include "pros/misc.hpp"
+#include <array>
+#include <cstdint>
+
+namespace movement {
+
+// Digital buttons on a V5 controller, L1 through A
+constexpr int kControllerButtons = 12;
+constexpr int kControllerAxes = 4;
+
+// Bit for a button in ControllerSnapshot masks
+constexpr std::uint16_t buttonBit(pros::controller_digital_e_t button) {
+    return static_cast<std::uint16_t>(1u << (button - pros::E_CONTROLLER_DIGITAL_L1));
+}
+
+// Button for a bit index in ControllerSnapshot masks
+constexpr pros::controller_digital_e_t buttonFromIndex(int index) {
+    return static_cast<pros::controller_digital_e_t>(pros::E_CONTROLLER_DIGITAL_L1 + index);
+}
+
+// One tick of controller input
+struct ControllerSnapshot {
+    std::uint16_t buttons = 0;                          // Held buttons, see buttonBit()
+    std::uint16_t previous = 0;                         // Held buttons on the previous tick
+    std::array<std::int8_t, kControllerAxes> axes{};    // Indexed by controller_analog_e_t
+    std::uint32_t timestamp = 0;
+    std::uint32_t sequence = 0;                         // Increments on every sample
+    bool connected = false;
+
+    // Button queries take a mask so several buttons can be tested at once
+    bool held(std::uint16_t mask) const { return (buttons & mask) == mask; }
+    std::uint16_t pressed() const { return buttons & ~previous; }
+    std::uint16_t released() const { return previous & ~buttons; }
+
+    bool held(pros::controller_digital_e_t button) const { return held(buttonBit(button)); }
+    bool newPress(pros::controller_digital_e_t button) const { return pressed() & buttonBit(button); }
+
+    // Raw axis value, -127 to 127
+    int axis(pros::controller_analog_e_t channel) const { return axes[channel]; }
+
+    // Axis value scaled to -1.0 to 1.0
+    double axisNormalized(pros::controller_analog_e_t channel) const { return axes[channel] / 127.0; }
+};
+
+// Alternative frame source (e.g. a recorded run) that stands in for the controller
+class ControllerSource {
+public:
+    virtual ~ControllerSource() = default;
+
+    // Fill buttons, axes and connected for this tick; false once the source is exhausted
+    virtual bool read(ControllerSnapshot& frame) = 0;
+};
+
+// Samples a controller once per tick and shares the snapshot with every consumer,
+// so the number of controller API calls does not grow with the number of bindings
+class ControllerState {
+private:
+    pros::Controller& controller_;
+    ControllerSnapshot snapshot_;
+    ControllerSource* source_ = nullptr;    // Replaces the controller while set
+
+    void readController(ControllerSnapshot& next) {
+        next.connected = controller_.is_connected() == 1;
+        if (!next.connected) return;
+
+        for (int i = 0; i < kControllerButtons; i++) {
+            if (controller_.get_digital(buttonFromIndex(i)) == 1) {
+                next.buttons |= static_cast<std::uint16_t>(1u << i);
+            }
+        }
+        for (int i = 0; i < kControllerAxes; i++) {
+            next.axes[i] = static_cast<std::int8_t>(
+                controller_.get_analog(static_cast<pros::controller_analog_e_t>(i)));
+        }
+    }
+
+public:
+    explicit ControllerState(pros::Controller& controller)
+        : controller_(controller) {}
+
+    // Read all buttons and axes; call exactly once per tick before any consumer updates
+    void sample() {
+        ControllerSnapshot next;
+        next.previous = snapshot_.buttons;
+        next.timestamp = pros::millis();
+        next.sequence = snapshot_.sequence + 1;
+
+        if (source_ && !source_->read(next)) {
+            source_ = nullptr; // Exhausted; hand control back to the controller
+            next.buttons = 0;
+            next.axes = {};
+            next.connected = false;
+        } else if (!source_) {
+            readController(next);
+        }
+
+        snapshot_ = next;
+    }
+
+    // Feed frames from another source instead of the controller (nullptr to stop)
+    void setSource(ControllerSource* source) { source_ = source; }
+    bool hasSource() const { return source_ != nullptr; }
+
+    const ControllerSnapshot& get() const { return snapshot_; }
+    pros::Controller& getController() { return controller_; }
+};
+
+} // namespace movement
@@ -0,0 +1,95 @@
+#pragma once
+#include "movement/chassis.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace movement {
+
+// Robot-frame velocity: forward and strafe (right positive) in in/s, yaw
+// rate in rad/s, clockwise positive like the heading
+struct BodyVelocity {
+    double forward = 0.0;
+    double strafe = 0.0;
+    double yaw_rate = 0.0;
+};
+
+// One value per corner wheel, in drive order
+struct WheelSpeeds {
+    enum Wheel : size_t { FRONT_LEFT, BACK_LEFT, FRONT_RIGHT, BACK_RIGHT };
+    std::array<double, 4> wheels{};
+
+    double& operator[](size_t wheel) { return wheels[wheel]; }
+    double operator[](size_t wheel) const { return wheels[wheel]; }
+
+    // Scale every wheel down together so none exceeds limit; the robot
+    // keeps its direction and turn, only slower
+    void desaturate(double limit) {
+        double peak = 0.0;
+        for (double speed : wheels) peak = std::max(peak, std::abs(speed));
+        if (peak <= limit || peak == 0.0) return;
+        for (double& speed : wheels) speed *= limit / peak;
+    }
+};
+
+// Wheel geometry of the four-wheel holonomic drives; only these are specialized
+template<DriveType DT>
+struct WheelGeometry;
+
+// Mecanum: wheels point forward and the rollers push sideways, so each wheel
+// turns one inch for an inch of forward or strafe travel
+template<>
+struct WheelGeometry<DriveType::MECANUM> {
+    static constexpr double kTranslation = 1.0;
+
+    template<typename Config>
+    static constexpr double turnRadius() {
+        return (Config::trackWidth + Config::wheelBase) / 2.0;
+    }
+};
+
+// X-drive: omni wheels at the corners, each turned 45 degrees, so a wheel
+// covers 1/sqrt(2) inch per inch of forward or strafe travel
+template<>
+struct WheelGeometry<DriveType::HOLONOMIC> {
+    static constexpr double kTranslation = M_SQRT1_2;
+
+    // std::sqrt is not constexpr, so this one is computed at startup
+    template<typename Config>
+    static double turnRadius() {
+        return std::sqrt(Config::trackWidth * Config::trackWidth + Config::wheelBase * Config::wheelBase) / 2.0;
+    }
+};
+
+// Inverse (body to wheels) and forward (wheels to body) kinematics, fixed at
+// compile time by Config::driveType. Wheel speeds are surface speeds, in/s.
+template<typename Config>
+struct HolonomicKinematics {
+    using Geometry = WheelGeometry<Config::driveType>;
+    static constexpr double kTranslation = Geometry::kTranslation;
+    static inline const double kTurnRadius = Geometry::template turnRadius<Config>();
+
+    // Same sign pattern as the wheel speeds; forward, strafe and turn are
+    // fractions of full speed, for open-loop commands
+    static WheelSpeeds mix(double forward, double strafe, double turn) {
+        return WheelSpeeds{{forward + strafe + turn, forward - strafe + turn,
+                            forward - strafe - turn, forward + strafe - turn}};
+    }
+
+    static WheelSpeeds inverse(const BodyVelocity& velocity) {
+        return mix(velocity.forward * kTranslation, velocity.strafe * kTranslation,
+                   velocity.yaw_rate * kTurnRadius);
+    }
+
+    // Least-squares body motion from four wheels; also takes wheel travel and gives travel
+    static BodyVelocity forward(const WheelSpeeds& w) {
+        using W = WheelSpeeds;
+        return BodyVelocity{
+            (w[W::FRONT_LEFT] + w[W::BACK_LEFT] + w[W::FRONT_RIGHT] + w[W::BACK_RIGHT]) / (4.0 * kTranslation),
+            (w[W::FRONT_LEFT] - w[W::BACK_LEFT] - w[W::FRONT_RIGHT] + w[W::BACK_RIGHT]) / (4.0 * kTranslation),
+            (w[W::FRONT_LEFT] + w[W::BACK_LEFT] - w[W::FRONT_RIGHT] - w[W::BACK_RIGHT]) / (4.0 * kTurnRadius)
+        };
+    }
+};
+
+} // namespace movement
@@ -1,26 +1,48 @@
 #pragma once
 #include "main.h"
 #include "movement/chassis.hpp"
+#include "movement/controller_state.hpp"
+#include "movement/heading_service.hpp"
+#include "movement/response_curve.hpp"
 #include "pros/misc.hpp"
 #include "core/subsystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 
 namespace movement {
 
 // Driver control modes
 enum class DriveMode {
-    ARCADE,     // Single stick arcade
-    SPLIT,      // Split arcade (drive/turn on separate sticks)
-    TANK        // Traditional tank
+    ARCADE,         // Single stick arcade
+    SPLIT,          // Split arcade (drive/turn on separate sticks; left X strafes on holonomic drives)
+    TANK,           // Traditional tank
+    HEADING_HOLD,   // Split arcade that holds the IMU heading while the turn stick is centered
+    FIELD_CENTRIC,  // Left stick is a field direction: a tank drive turns to it, a holonomic drive slides; right stick turns
+    CURVATURE       // Right stick sets how sharply the robot curves, not how fast it spins
 };
 
 // Driver control configuration
 struct DriverConfig {
     DriveMode mode = DriveMode::ARCADE;
-    double curve_factor = 1.5;      // Input curve for smoother control
+    CurveType curve_type = CurveType::POWER;
+    double curve_factor = 1.5;      // Input curve for smoother control, see CurveType
     double deadzone = 0.05;         // Joystick deadzone
     double turn_scale = 0.8;        // Turn speed scaling
     int controller_id = 0;          // Primary = 0, Partner = 1
+
+    // Heading assist (HEADING_HOLD and FIELD_CENTRIC)
+    double heading_kp = 1.5;        // Turn command per radian of heading error
+    std::uint32_t hold_delay_ms = 150;   // Lets rotation coast out before capturing the heading to hold
+    bool snap_to_angle = true;      // D-pad snaps to the nearest field axis: up 0, right 90, down 180, left 270
+
+    // CURVATURE: tightest turn radius at full right stick, inches. With the left
+    // stick centered the right stick turns in place as in SPLIT.
+    double min_turn_radius = 12.0;
+
+    // Raw stick value (0-127) that takes the drive back from a running motion; 0 never preempts
+    int preempt_threshold = 40;
 };
 
 // Driver control class that works with our chassis
@@ -30,80 +52,203 @@ private:
     std::string name_;
     Chassis<ChassisConfig>& chassis_;
     DriverConfig config_;
-    pros::Controller controller_;
+    const ControllerState& input_;
+    const ControllerState* replay_input_ = nullptr;     // Drives during autonomous while it has a source
+    ResponseCurve curve_;           // Deadzone and curve, indexed by raw stick value
     bool enabled_ = false;
 
-    // Input processing
-    double applyDeadzone(double input) const {
-        return std::abs(input) < config_.deadzone ? 0.0 : input;
-    }
+    // Heading assist state
+    double field_offset_ = 0.0;     // Chassis heading when facing away from the alliance wall
+    double hold_target_ = 0.0;      // Field heading being held
+    bool holding_ = false;
+    std::uint32_t last_turn_ms_ = 0;     // Last tick the driver commanded a turn
+    bool idle_ = false;             // Last command written was a full stop
 
-    double applyCurve(double input) const {
-        return std::pow(std::abs(input), config_.curve_factor) * (input < 0 ? -1 : 1);
+    // Input processing
+    void rebuildCurve() {
+        curve_.build(config_.curve_type, config_.curve_factor, config_.deadzone);
     }
 
     void processTankDrive() {
         if (!enabled_) return;
         
-        double left = applyDeadzone(controller_.get_analog(ANALOG_LEFT_Y) / 127.0);
-        double right = applyDeadzone(controller_.get_analog(ANALOG_RIGHT_Y) / 127.0);
-        
-        left = applyCurve(left);
-        right = applyCurve(right);
+        const auto& input = input_.get();
+        double left = curve_(input.axis(ANALOG_LEFT_Y));
+        double right = curve_(input.axis(ANALOG_RIGHT_Y));
 
-        // Apply to left/right motor groups
-        for (size_t i = 0; i < chassis_.getMotorCount(); i++) {
-            bool is_left = i < chassis_.getMotorCount()/2;
-            chassis_.setMotorVelocity(i, (is_left ? left : right) * 200.0);
-        }
+        applyDrive((left + right) / 2.0, 0.0, (left - right) / 2.0);
+    }
+
+    // Hand forward, strafe and turn (-1.0 to 1.0, positive turn is clockwise)
+    // to the chassis, which mixes them for its drive. Centered sticks send one
+    // stop and then leave the motors alone, so macros and autonomous code are not overridden.
+    void applyDrive(double forward, double strafe, double turn) {
+        bool idle = forward == 0.0 && strafe == 0.0 && turn == 0.0;
+        if (idle && idle_) return;
+        idle_ = idle;
+
+        chassis_.drive(forward, strafe, turn);
     }
 
     void processArcadeDrive(bool split) {
         if (!enabled_) return;
 
-        double drive, turn;
-        if (split) {
-            drive = applyDeadzone(controller_.get_analog(ANALOG_LEFT_Y) / 127.0);
-            turn = applyDeadzone(controller_.get_analog(ANALOG_RIGHT_X) / 127.0);
-        } else {
-            drive = applyDeadzone(controller_.get_analog(ANALOG_LEFT_Y) / 127.0);
-            turn = applyDeadzone(controller_.get_analog(ANALOG_LEFT_X) / 127.0);
+        const auto& input = input_.get();
+        double drive = curve_(input.axis(ANALOG_LEFT_Y));
+        double strafe = split ? curve_(input.axis(ANALOG_LEFT_X)) : 0.0;
+        double turn = curve_(input.axis(split ? ANALOG_RIGHT_X : ANALOG_LEFT_X)) * config_.turn_scale;
+
+        applyDrive(drive, strafe, turn);
+    }
+
+    // True when the driver is pushing any stick hard enough to take over
+    bool wantsControl() const {
+        if (config_.preempt_threshold <= 0) return false;
+
+        const auto& input = input_.get();
+        for (auto axis : {ANALOG_LEFT_X, ANALOG_LEFT_Y, ANALOG_RIGHT_X, ANALOG_RIGHT_Y}) {
+            if (std::abs(input.axis(axis)) >= config_.preempt_threshold) return true;
+        }
+        return false;
+    }
+
+    // Turn rate follows speed, so a given right stick always draws the same arc
+    void processCurvature() {
+        const auto& input = input_.get();
+        double drive = curve_(input.axis(ANALOG_LEFT_Y));
+        double turn = curve_(input.axis(ANALOG_RIGHT_X));
+
+        if (drive == 0.0) {
+            applyDrive(0.0, 0.0, turn * config_.turn_scale);
+            return;
         }
+        idle_ = false;
+        chassis_.curvatureDrive(drive, turn / config_.min_turn_radius);
+    }
+
+    double fieldHeading() const {
+        return chassis_.getHeading() - field_offset_;
+    }
 
-        drive = applyCurve(drive);
-        turn = applyCurve(turn) * config_.turn_scale;
+    // Turn command that drives the field heading toward target
+    double headingCorrection(double target) const {
+        double error = wrapAngle(target - fieldHeading());
+        return std::clamp(config_.heading_kp * error, -config_.turn_scale, config_.turn_scale);
+    }
 
-        double left = drive + turn;
-        double right = drive - turn;
+    // D-pad snap targets, clockwise from straight away from the alliance wall
+    void checkSnap(const ControllerSnapshot& input) {
+        if (!config_.snap_to_angle) return;
 
-        // Normalize if over ±1.0
-        double max = std::max(std::abs(left), std::abs(right));
-        if (max > 1.0) {
-            left /= max;
-            right /= max;
+        static constexpr pros::controller_digital_e_t kSnapButtons[] = {
+            DIGITAL_UP, DIGITAL_RIGHT, DIGITAL_DOWN, DIGITAL_LEFT
+        };
+        for (int i = 0; i < 4; i++) {
+            if (input.newPress(kSnapButtons[i])) {
+                hold_target_ = i * M_PI / 2.0;
+                holding_ = true;
+            }
         }
+    }
+
+    // Manual turn passes through; once the stick is centered and the robot has
+    // stopped rotating, the current heading is captured and held
+    double assistTurn(double manual_turn, const ControllerSnapshot& input) {
+        checkSnap(input);
 
-        // Apply to motors
-        for (size_t i = 0; i < chassis_.getMotorCount(); i++) {
-            bool is_left = i < chassis_.getMotorCount()/2;
-            chassis_.setMotorVelocity(i, (is_left ? left : right) * 200.0);
+        if (manual_turn != 0.0) {
+            holding_ = false;
+            last_turn_ms_ = input.timestamp;
+            return manual_turn;
         }
+        if (!holding_) {
+            if (input.timestamp - last_turn_ms_ < config_.hold_delay_ms) return 0.0;
+            hold_target_ = fieldHeading();
+            holding_ = true;
+        }
+        return headingCorrection(hold_target_);
+    }
+
+    void processHeadingHold() {
+        const auto& input = input_.get();
+        double drive = curve_(input.axis(ANALOG_LEFT_Y));
+        double strafe = curve_(input.axis(ANALOG_LEFT_X));
+        double turn = curve_(input.axis(ANALOG_RIGHT_X)) * config_.turn_scale;
+
+        applyDrive(drive, strafe, assistTurn(turn, input));
+    }
+
+    // The left stick is a field direction and speed. A holonomic drive slides
+    // that way while holding its heading; a tank chassis cannot strafe, so it
+    // turns toward the direction and drives whichever end is closer.
+    void processFieldCentric() {
+        const auto& input = input_.get();
+        double x = curve_(input.axis(ANALOG_LEFT_X));
+        double y = curve_(input.axis(ANALOG_LEFT_Y));
+        double turn = curve_(input.axis(ANALOG_RIGHT_X)) * config_.turn_scale;
+        double speed = std::min(std::hypot(x, y), 1.0);
+
+        if constexpr (ChassisConfig::driveType != DriveType::TANK) {
+            // Field stick into the robot's frame
+            double heading = fieldHeading();
+            double forward = y * std::cos(heading) + x * std::sin(heading);
+            double strafe = x * std::cos(heading) - y * std::sin(heading);
+            applyDrive(forward, strafe, assistTurn(turn, input));
+            return;
+        }
+
+        if (speed == 0.0 || turn != 0.0) {
+            applyDrive(0.0, 0.0, assistTurn(turn, input));
+            return;
+        }
+
+        double target = std::atan2(x, y);
+        double error = wrapAngle(target - fieldHeading());
+        if (std::abs(error) > M_PI / 2.0) {
+            target = wrapAngle(target + M_PI);
+            error = wrapAngle(error + M_PI);
+            speed = -speed;
+        }
+
+        // Ease off forward speed until the robot is roughly lined up
+        hold_target_ = target;
+        holding_ = true;
+        applyDrive(speed * std::cos(error), 0.0, headingCorrection(target));
     }
 
 public:
     DriverControl(const std::string& name, Chassis<ChassisConfig>& chassis, 
+                 const ControllerState& input,
                  const DriverConfig& config = DriverConfig())
         : name_(name)
         , chassis_(chassis)
         , config_(config)
-        , controller_(config.controller_id == 0 ? 
-              pros::Controller(pros::E_CONTROLLER_MASTER) 
-            : pros::Controller(pros::E_CONTROLLER_PARTNER)) {}
+        , input_(input) {
+        rebuildCurve();
+    }
 
     // ISubsystem interface implementation
     void initialize() override { enabled_ = true; }
+    void enable() override {
+        enabled_ = true;
+        holding_ = false;
+        idle_ = true;   // Leave whatever the new period starts with until a stick moves
+    }
     void update() override {
         if (!enabled_) return;
+
+        // Autonomous code drives the motors, unless a recorded run is standing in for the driver
+        if (pros::competition::is_autonomous() && !(replay_input_ && replay_input_->hasSource())) return;
+
+        // A running chassis motion (macro or autonomous) owns the motors until
+        // the driver pushes a stick. Listeners stop whatever started the motion
+        // first, so it cannot start the next one; the driver has the motors this tick.
+        if (chassis_.isMotionActive()) {
+            idle_ = false;
+            if (!wantsControl()) return;
+            core::EventSystem::getInstance().emit<bool>("driver_preempt", true);
+            chassis_.cancelMotion(StopBehavior::COAST);
+        }
         
         switch (config_.mode) {
             case DriveMode::TANK:
@@ -115,6 +260,20 @@ public:
             case DriveMode::SPLIT:
                 processArcadeDrive(true);
                 break;
+            case DriveMode::CURVATURE:
+                processCurvature();
+                break;
+            case DriveMode::HEADING_HOLD:
+            case DriveMode::FIELD_CENTRIC:
+                // Without a settled heading the assist would fight the driver
+                if (!chassis_.areSensorsReady()) {
+                    processArcadeDrive(true);
+                } else if (config_.mode == DriveMode::HEADING_HOLD) {
+                    processHeadingHold();
+                } else {
+                    processFieldCentric();
+                }
+                break;
         }
     }
     
@@ -127,10 +286,25 @@ public:
     const std::string& getName() const override { return name_; }
 
     // Configuration methods
-    void setMode(DriveMode mode) { config_.mode = mode; }
-    void setCurveFactor(double factor) { config_.curve_factor = factor; }
-    void setDeadzone(double deadzone) { config_.deadzone = deadzone; }
+    void setMode(DriveMode mode) {
+        config_.mode = mode;
+        holding_ = false;
+    }
+    void setCurveType(CurveType type) { config_.curve_type = type; rebuildCurve(); }
+    void setCurveFactor(double factor) { config_.curve_factor = factor; rebuildCurve(); }
+    void setDeadzone(double deadzone) { config_.deadzone = deadzone; rebuildCurve(); }
     void setTurnScale(double scale) { config_.turn_scale = scale; }
+    void setHeadingGain(double kp) { config_.heading_kp = kp; }
+
+    // Declare the robot's current field heading (0 faces away from the alliance wall)
+    void setFieldHeading(double field_heading) {
+        field_offset_ = chassis_.getHeading() - field_heading;
+        holding_ = false;
+    }
+
+    // Controller that a recorded run is fed into; DriverControl only drives
+    // during autonomous while it is replaying
+    void setReplayInput(const ControllerState* input) { replay_input_ = input; }
 
     // Get current config
     const DriverConfig& getConfig() const { return config_; }
@@ -0,0 +1,77 @@
+#pragma once
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace movement {
+
+// Multipliers for a GainSchedule, as kept in the robot configuration
+struct GainScaling {
+    std::vector<std::pair<double, double>> by_voltage;  // (volts, scale) points
+    double loaded = 1.0;                                // While carrying a payload
+};
+
+// A controller gain that changes with battery voltage and payload. Voltage
+// points multiply the base gain and are interpolated between; outside them
+// the nearest point holds. The payload factor applies on top.
+class GainSchedule {
+private:
+    struct Point {
+        double voltage;
+        double scale;
+    };
+
+    double base_;
+    std::vector<Point> points_;         // Sorted by voltage
+    double loaded_scale_ = 1.0;
+
+public:
+    explicit GainSchedule(double base = 0.0) : base_(base) {}
+
+    void setBase(double base) { base_ = base; }
+    double getBase() const { return base_; }
+
+    // Multiply the gain by `scale` at `voltage`; replaces an existing point
+    GainSchedule& at(double voltage, double scale) {
+        auto it = std::lower_bound(points_.begin(), points_.end(), voltage,
+            [](const Point& point, double v) { return point.voltage < v; });
+        if (it != points_.end() && it->voltage == voltage) {
+            it->scale = scale;
+        } else {
+            points_.insert(it, Point{voltage, scale});
+        }
+        return *this;
+    }
+
+    // Multiply the gain by `scale` while carrying a payload
+    GainSchedule& whenLoaded(double scale) {
+        loaded_scale_ = scale;
+        return *this;
+    }
+
+    // Apply every point and the payload factor of a configured scaling
+    GainSchedule& apply(const GainScaling& scaling) {
+        for (const auto& [voltage, scale] : scaling.by_voltage) at(voltage, scale);
+        return whenLoaded(scaling.loaded);
+    }
+
+    double get(double voltage, bool loaded) const {
+        double scale = 1.0;
+        if (!points_.empty()) {
+            if (voltage <= points_.front().voltage) {
+                scale = points_.front().scale;
+            } else if (voltage >= points_.back().voltage) {
+                scale = points_.back().scale;
+            } else {
+                auto high = std::lower_bound(points_.begin(), points_.end(), voltage,
+                    [](const Point& point, double v) { return point.voltage < v; });
+                auto low = high - 1;
+                double t = (voltage - low->voltage) / (high->voltage - low->voltage);
+                scale = low->scale + (high->scale - low->scale) * t;
+            }
+        }
+        return base_ * scale * (loaded ? loaded_scale_ : 1.0);
+    }
+};
+
+} // namespace movement
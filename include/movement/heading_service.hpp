@@ -0,0 +1,320 @@
+#pragma once
+#include "main.h"
+#include "pros/imu.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace movement {
+
+// Wrap an angle in radians to [-pi, pi]
+inline double wrapAngle(double angle) {
+    return std::remainder(angle, 2.0 * M_PI);
+}
+
+// How readings from several IMUs are combined
+enum class HeadingFusion {
+    AVERAGE,    // Mean of all healthy IMUs
+    MEDIAN      // Median vote, outvotes a single bad IMU when three or more are fitted
+};
+
+// Continuous (unwrapped) heading from one or more IMUs.
+// All IMUs are read at most once per tick; repeated queries return the cached value.
+class HeadingService {
+private:
+    struct ImuChannel {
+        std::unique_ptr<pros::IMU> imu;
+        int port;
+        double offset = 0.0;        // Degrees removed so every IMU agrees after tare
+        double drift_rate = 0.0;    // Residual gyro bias in degrees per second
+        double drift = 0.0;         // Drift accumulated since tare, degrees
+        double last_reading = 0.0;  // Corrected reading from the latest sample, degrees
+        double last_raw = 0.0;      // Uncorrected rotation from the latest sample, degrees
+        bool healthy = false;
+
+        // Stationary bias window
+        double window_start_raw = 0.0;
+        std::uint32_t window_start_ms = 0;
+        bool window_open = false;
+    };
+
+    // On-disk bias cache: header followed by one record per IMU
+    static constexpr std::uint32_t kBiasFileMagic = 0x42554D49; // "IMUB"
+    static constexpr std::uint16_t kBiasFileVersion = 1;
+
+    struct BiasFileHeader {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t count;
+    };
+
+    struct BiasRecord {
+        std::uint8_t port;
+        std::uint8_t reserved[3];
+        float drift_rate;
+    };
+
+    // Bias estimation tuning
+    static constexpr std::uint32_t kBiasWindowMs = 2000;     // Stationary time per estimate
+    static constexpr double kBiasFilterGain = 0.3;          // Weight of each new estimate
+    static constexpr double kMaxBiasDps = 0.5;              // Larger values mean the robot moved
+    static constexpr double kStationaryGyroDps = 2.0;
+
+    mutable std::vector<ImuChannel> imus_;  // Channels hold the per-tick cached readings
+    mutable std::vector<double> readings_;  // Scratch space for fusion, sized in addImu
+    HeadingFusion fusion_ = HeadingFusion::MEDIAN;
+
+    mutable double heading_ = 0.0;          // Radians, unwrapped
+    mutable std::uint32_t last_sample_ = 0;
+    mutable bool sampled_ = false;
+    // Readings are held until the next tare. Calibration runs on the sensor task:
+    // tare() writes the offsets and biases, then publishes them by clearing this
+    // flag with a release store; readers on other tasks check it with acquire.
+    std::atomic<bool> calibrating_{false};
+    bool bias_dirty_ = false;               // Drift rates changed since the last save
+
+    void sample(std::uint32_t now) const {
+        double dt = sampled_ ? (now - last_sample_) / 1000.0 : 0.0;
+        readings_.clear();
+
+        for (auto& channel : imus_) {
+            double raw = channel.imu->get_rotation();
+            channel.healthy = std::isfinite(raw) && raw != PROS_ERR_F;
+            if (!channel.healthy) continue;
+
+            channel.last_raw = raw;
+            channel.drift += channel.drift_rate * dt;
+            channel.last_reading = raw - channel.offset - channel.drift;
+            readings_.push_back(channel.last_reading);
+        }
+
+        if (!readings_.empty()) {
+            heading_ = fuse() * M_PI / 180.0;
+        }
+        last_sample_ = now;
+        sampled_ = true;
+    }
+
+    double fuse() const {
+        size_t n = readings_.size();
+        if (fusion_ == HeadingFusion::AVERAGE || n < 3) {
+            double sum = 0.0;
+            for (double r : readings_) sum += r;
+            return sum / n;
+        }
+
+        auto mid = readings_.begin() + n / 2;
+        std::nth_element(readings_.begin(), mid, readings_.end());
+        if (n % 2 == 1) return *mid;
+        double lower = *std::max_element(readings_.begin(), mid);
+        return (lower + *mid) / 2.0;
+    }
+
+public:
+    HeadingService() = default;
+
+    // Sensor management
+    void addImu(int port) {
+        if (hasImu(port)) return;
+        ImuChannel channel;
+        channel.imu = std::make_unique<pros::IMU>(port);
+        channel.port = port;
+        imus_.push_back(std::move(channel));
+        readings_.reserve(imus_.size());
+    }
+
+    bool hasImu(int port) const {
+        return std::any_of(imus_.begin(), imus_.end(),
+            [port](const ImuChannel& c) { return c.port == port; });
+    }
+
+    bool hasImus() const { return !imus_.empty(); }
+    size_t getImuCount() const { return imus_.size(); }
+    pros::IMU& getImu(size_t index) { return *imus_.at(index).imu; }
+
+    void setFusion(HeadingFusion fusion) { fusion_ = fusion; }
+    HeadingFusion getFusion() const { return fusion_; }
+
+    // Residual gyro bias for one IMU, removed from every subsequent reading
+    void setDriftRate(size_t index, double deg_per_sec) {
+        imus_.at(index).drift_rate = deg_per_sec;
+    }
+
+    // Start calibrating every IMU at once without blocking
+    void startCalibration() {
+        calibrating_.store(true, std::memory_order_release);
+        for (auto& channel : imus_) {
+            channel.imu->reset(false);
+        }
+    }
+
+    // True while any connected IMU still reports the calibrating status bit
+    bool isCalibrating() const {
+        return std::any_of(imus_.begin(), imus_.end(), [](const ImuChannel& c) {
+            auto status = c.imu->get_status();
+            if (status == pros::ImuStatus::error) return false; // Unplugged IMUs never finish
+            return (static_cast<std::uint32_t>(status) & pros::E_IMU_STATUS_CALIBRATING) != 0;
+        });
+    }
+
+    // Make every IMU report the given heading (radians) from now on
+    void tare(double heading = 0.0) {
+        double target = heading * 180.0 / M_PI;
+        for (auto& channel : imus_) {
+            double raw = channel.imu->get_rotation();
+            channel.offset = std::isfinite(raw) && raw != PROS_ERR_F ? raw - target : -target;
+            channel.drift = 0.0;
+            channel.window_open = false;
+        }
+        heading_ = heading;
+        sampled_ = false;
+        calibrating_.store(false, std::memory_order_release);
+    }
+
+    // Refine each IMU's drift rate from how far it wanders while the robot is still.
+    // Call once per tick; returns true when a new estimate was folded in.
+    bool refineBias(bool stationary) {
+        if (imus_.empty() || calibrating_.load(std::memory_order_acquire)) return false;
+        getHeading();
+
+        bool updated = false;
+        for (auto& channel : imus_) {
+            bool still = stationary && channel.healthy &&
+                         std::abs(channel.imu->get_gyro_rate().z) < kStationaryGyroDps;
+            if (!still) {
+                channel.window_open = false;
+                continue;
+            }
+            if (!channel.window_open) {
+                channel.window_start_raw = channel.last_raw;
+                channel.window_start_ms = last_sample_;
+                channel.window_open = true;
+                continue;
+            }
+
+            std::uint32_t elapsed = last_sample_ - channel.window_start_ms;
+            if (elapsed < kBiasWindowMs) continue;
+
+            double rate = (channel.last_raw - channel.window_start_raw) * 1000.0 / elapsed;
+            if (std::abs(rate) < kMaxBiasDps) {
+                channel.drift_rate += kBiasFilterGain * (rate - channel.drift_rate);
+                updated = true;
+            }
+            channel.window_start_raw = channel.last_raw;
+            channel.window_start_ms = last_sample_;
+        }
+
+        bias_dirty_ = bias_dirty_ || updated;
+        return updated;
+    }
+
+    bool isBiasDirty() const { return bias_dirty_; }
+
+    // Write every IMU's drift rate to the SD card
+    bool saveBias(const char* path) {
+        if (imus_.empty() || !pros::usd::is_installed()) return false;
+
+        FILE* file = std::fopen(path, "wb");
+        if (!file) return false;
+
+        BiasFileHeader header{kBiasFileMagic, kBiasFileVersion,
+                              static_cast<std::uint16_t>(imus_.size())};
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        for (const auto& channel : imus_) {
+            BiasRecord record{static_cast<std::uint8_t>(channel.port), {0, 0, 0},
+                              static_cast<float>(channel.drift_rate)};
+            ok = ok && std::fwrite(&record, sizeof(record), 1, file) == 1;
+        }
+        std::fclose(file);
+
+        if (ok) bias_dirty_ = false;
+        return ok;
+    }
+
+    // Restore drift rates saved by a previous boot, matched by port
+    bool loadBias(const char* path) {
+        if (imus_.empty() || !pros::usd::is_installed()) return false;
+
+        FILE* file = std::fopen(path, "rb");
+        if (!file) return false;
+
+        BiasFileHeader header{};
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  header.magic == kBiasFileMagic && header.version == kBiasFileVersion;
+
+        for (std::uint16_t i = 0; ok && i < header.count; i++) {
+            BiasRecord record{};
+            if (std::fread(&record, sizeof(record), 1, file) != 1) {
+                ok = false;
+                break;
+            }
+            if (!std::isfinite(record.drift_rate) || std::abs(record.drift_rate) >= kMaxBiasDps) {
+                continue;
+            }
+            for (auto& channel : imus_) {
+                if (channel.port == record.port) {
+                    channel.drift_rate = record.drift_rate;
+                }
+            }
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    // Force the next query to read the IMUs again
+    void invalidate() { sampled_ = false; }
+
+    // Unwrapped heading in radians, refreshed once per millisecond tick
+    double getHeading() const {
+        if (imus_.empty() || calibrating_.load(std::memory_order_acquire)) return heading_;
+        std::uint32_t now = pros::millis();
+        if (!sampled_ || now != last_sample_) {
+            sample(now);
+        }
+        return heading_;
+    }
+
+    // Heading wrapped to [-pi, pi]
+    double getWrappedHeading() const { return wrapAngle(getHeading()); }
+
+    // Forward (x-axis) acceleration averaged over healthy IMUs, in g
+    double getForwardAccel() const {
+        double sum = 0.0;
+        int count = 0;
+        for (const auto& channel : imus_) {
+            if (!channel.healthy) continue;
+            double accel = channel.imu->get_accel().x;
+            if (!std::isfinite(accel) || accel == PROS_ERR_F) continue;
+            sum += accel;
+            count++;
+        }
+        return count > 0 ? sum / count : 0.0;
+    }
+
+    // Largest pitch or roll magnitude over healthy IMUs, in degrees
+    double getTilt() const {
+        double tilt = 0.0;
+        for (const auto& channel : imus_) {
+            if (!channel.healthy) continue;
+            double pitch = channel.imu->get_pitch();
+            double roll = channel.imu->get_roll();
+            if (!std::isfinite(pitch) || pitch == PROS_ERR_F) continue;
+            if (!std::isfinite(roll) || roll == PROS_ERR_F) continue;
+            tilt = std::max({tilt, std::abs(pitch), std::abs(roll)});
+        }
+        return tilt;
+    }
+
+    // Number of IMUs that returned a valid reading in the latest sample
+    size_t getHealthyCount() const {
+        getHeading();
+        return std::count_if(imus_.begin(), imus_.end(),
+            [](const ImuChannel& c) { return c.healthy; });
+    }
+};
+
+} // namespace movement
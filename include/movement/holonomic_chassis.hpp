@@ -0,0 +1,262 @@
+// include/movement/holonomic_chassis.hpp
+
+#pragma once
+#include "movement/chassis.hpp"
+#include "movement/drive_kinematics.hpp"
+
+namespace movement {
+
+// Four-corner holonomic drive (mecanum or X-drive, from Config::driveType).
+// Motors are added left side first, front to back, then the right side, as on
+// the tank drive; with more than four motors each corner gets an equal group.
+// Right-side motors are reversed so a positive command drives every wheel forward.
+template<typename Config>
+class HolonomicChassis : public Chassis<Config> {
+    static_assert(Config::driveType == DriveType::MECANUM || Config::driveType == DriveType::HOLONOMIC,
+                  "HolonomicChassis needs a MECANUM or HOLONOMIC config; use TankChassis for tank drives");
+
+private:
+    using Base = Chassis<Config>;
+    using Base::motors_;
+    using Base::encoders_;
+    using Base::current_pos_;
+    using Base::heading_;
+    using Base::slip_detector_;
+    using Kinematics = HolonomicKinematics<Config>;
+
+    // Gains, the same scale as the tank drive's
+    static constexpr double kP = 0.8;
+    static constexpr double kTurnP = 1.2;
+    static constexpr double kSettleRadius = 4.0;    // Inches; inside it moveTo stops turning to face the target
+    static constexpr double kCurveHeadingP = 4.0;   // Extra turn rate (rad/s) per radian behind the reference heading
+
+    // Gains scheduled on battery voltage and payload; flat at the constants above until configured
+    GainSchedule drive_gain_{kP};
+    GainSchedule turn_gain_{kTurnP};
+    GainSchedule heading_gain_{kCurveHeadingP};
+
+    // Odometry noise model
+    static constexpr double kDistanceNoise = 0.03;          // Std dev per inch travelled; rollers slip more
+    static constexpr double kImuHeadingNoise = 0.0005;      // Std dev per tick with an IMU, rad
+    static constexpr double kEncoderHeadingNoise = 0.015;   // Std dev per radian of wheel-measured turn
+    static constexpr double kMaxOdomStep = 0.1;             // Seconds; longer gaps skip slip checks
+
+    struct OdomState {
+        WheelSpeeds travel;             // Wheel travel at the last update, inches
+        double velocity = 0.0;          // Fused forward velocity, in/s
+        double encoder_velocity = 0.0;  // Wheel-only forward velocity, in/s
+        std::uint32_t last_ms = 0;
+        std::uint32_t data_ms = 0;      // Device timestamp of the encoder data used
+        bool initialized = false;
+    };
+    mutable OdomState odom_;
+
+    // Corner wheel driven by a motor
+    size_t wheelOf(size_t motor) const {
+        size_t per_wheel = std::max<size_t>(motors_.size() / 4, 1);
+        return std::min<size_t>(motor / per_wheel, 3);
+    }
+
+    // Per-wheel average of a motor reading (degrees or degrees per second), as wheel inches
+    template<typename Read>
+    WheelSpeeds wheelAverage(Read read) const {
+        WheelSpeeds sum;
+        std::array<int, 4> count{};
+        for (size_t i = 0; i < motors_.size(); i++) {
+            sum[wheelOf(i)] += read(encoders_[i]);
+            count[wheelOf(i)]++;
+        }
+        for (size_t w = 0; w < 4; w++) {
+            if (count[w] > 0) sum[w] = sum[w] / count[w] / 360.0 * (Config::wheelDiameter * M_PI) * Config::gearRatio;
+        }
+        return sum;
+    }
+
+    WheelSpeeds wheelTravel() const {
+        return wheelAverage([](const MotorEncoder& encoder) { return encoder.getPosition(); });
+    }
+
+    WheelSpeeds wheelVelocity() const {
+        return wheelAverage([](const MotorEncoder& encoder) { return encoder.getVelocity(); });
+    }
+
+    // Integrate wheel travel and IMU heading into the pose whenever new encoder
+    // data arrives. Forward travel is checked against the IMU for slip as on
+    // the tank drive; strafe comes from the wheels alone.
+    void updateOdometry() const {
+        if constexpr (Config::odomType == OdomType::NONE) return;
+
+        std::uint32_t now = pros::millis();
+        if (odom_.initialized && now == odom_.last_ms) return;
+        odom_.last_ms = now;
+
+        bool fresh = this->sampleEncoders();
+        if (odom_.initialized && !fresh && !motors_.empty()) return; // No new encoder data yet
+        std::uint32_t data_ms = motors_.empty() ? now : this->encoder_timestamp_;
+
+        WheelSpeeds travel = wheelTravel();
+        bool has_imu = heading_.hasImus();
+        double heading = has_imu ? heading_.getHeading() : current_pos_.heading;
+
+        if (!odom_.initialized) {
+            odom_ = OdomState{travel, 0.0, 0.0, now, data_ms, true};
+            current_pos_.heading = heading;
+            return;
+        }
+
+        double dt = (data_ms - odom_.data_ms) / 1000.0;
+        if (dt <= 0.0) return;
+
+        WheelSpeeds delta;
+        for (size_t w = 0; w < 4; w++) delta[w] = travel[w] - odom_.travel[w];
+        BodyVelocity step = Kinematics::forward(delta);
+        double dtheta = has_imu ? heading - current_pos_.heading : step.yaw_rate;
+
+        BodyVelocity measured = Kinematics::forward(wheelVelocity());
+        double velocity = step.forward / dt;
+
+        // After a long gap (e.g. pushed while disabled) just take the wheel travel
+        if (has_imu && dt <= kMaxOdomStep) {
+            double encoder_accel = (measured.forward - odom_.encoder_velocity) / dt;
+            double imu_accel = heading_.getForwardAccel() * kGravityInPerSec2;
+            const auto& quality = slip_detector_.update(
+                measured.yaw_rate, dtheta / dt, encoder_accel, imu_accel, now);
+
+            // Lean on the IMU-propagated velocity while the wheels cannot be trusted
+            double imu_velocity = odom_.velocity + imu_accel * dt;
+            velocity = quality.encoder_weight * velocity +
+                       (1.0 - quality.encoder_weight) * imu_velocity;
+        }
+
+        double forward = velocity * dt;
+        double strafe = step.strafe;
+        double distance = std::hypot(forward, strafe);
+        double mid_heading = current_pos_.heading + dtheta / 2.0;
+        double direction = mid_heading + std::atan2(strafe, forward);
+
+        double encoder_weight = slip_detector_.getQuality().encoder_weight;
+        double var_distance = std::pow(kDistanceNoise * distance, 2) / encoder_weight;
+        double var_heading = has_imu ? kImuHeadingNoise * kImuHeadingNoise
+                                     : std::pow(kEncoderHeadingNoise * step.yaw_rate, 2);
+        current_pos_.propagate(distance, direction, var_distance, var_heading);
+
+        // Strafing right is a quarter turn clockwise from forward
+        current_pos_.x += forward * std::cos(mid_heading) - strafe * std::sin(mid_heading);
+        current_pos_.y += forward * std::sin(mid_heading) + strafe * std::cos(mid_heading);
+        current_pos_.heading += dtheta;
+
+        odom_ = OdomState{travel, velocity, measured.forward, now, data_ms, true};
+    }
+
+protected:
+    // Raise a command's magnitude to at least min_speed, keeping its sign
+    static double applyMinSpeed(double power, double min_speed) {
+        if (min_speed <= 0.0 || std::abs(power) >= min_speed) return power;
+        return power < 0.0 ? -min_speed : min_speed;
+    }
+
+    // Command the corners in RPM, scaled down together to what the battery
+    // can deliver so the robot keeps its direction when a wheel would saturate
+    void driveWheels(WheelSpeeds rpm) {
+        rpm.desaturate(this->maxRpm());
+        for (size_t i = 0; i < motors_.size(); i++) {
+            this->writeMotor(i, rpm[wheelOf(i)]);
+        }
+    }
+
+    // Translate straight at the target while turning to face it (or away from
+    // it with reverse), so it ends up where a tank drive would. Close in it
+    // stops turning, as the tank drive stops steering.
+    double stepMoveTo(const field::Point& target, bool reverse, double min_speed) override {
+        Position current = this->getPosition();
+        double distance = current.distanceTo(target);
+        double bearing = current.angleTo(target);
+
+        double speed = std::clamp(this->scheduled(drive_gain_) * distance, 0.0, 1.0);
+        speed = applyMinSpeed(speed, min_speed);
+
+        double facing = reverse ? bearing + M_PI : bearing;
+        double turn = distance > kSettleRadius
+            ? this->scheduled(turn_gain_) * wrapAngle(facing - current.heading) : 0.0;
+
+        // Direction of travel relative to where the robot points
+        double relative = bearing - current.heading;
+        drive(speed * std::cos(relative), speed * std::sin(relative), turn);
+        return distance;
+    }
+
+    double stepTurnTo(double angle, double min_speed) override {
+        double current = this->getPosition().heading;
+        double error = wrapAngle(angle - current);
+
+        double power = applyMinSpeed(std::clamp(this->scheduled(turn_gain_) * error, -1.0, 1.0), min_speed);
+        drive(0.0, 0.0, power);
+        return std::abs(error);
+    }
+
+    // Center speed and turn rate through the inverse kinematics. A swing picks
+    // the center speed that cancels the turn term on the locked side, so its
+    // wheels stay still; the roller geometry makes that faster than a tank
+    // drive's half track width times the turn rate.
+    void driveCurve(double velocity, double yaw_rate, double heading_error,
+                    bool swing, SwingSide locked) override {
+        double turn = yaw_rate + this->scheduled(heading_gain_) * heading_error;
+        if (swing) {
+            double pivot = Kinematics::kTurnRadius / Kinematics::kTranslation;
+            velocity = (locked == SwingSide::LEFT ? -turn : turn) * pivot;
+        }
+
+        WheelSpeeds wheels = Kinematics::inverse(BodyVelocity{velocity, 0.0, turn});
+        double to_rpm = Base::kMaxRpm / Base::topSpeed();
+        for (double& speed : wheels.wheels) speed *= to_rpm;
+        driveWheels(wheels);
+    }
+
+public:
+    explicit HolonomicChassis(const std::string& name = "holonomic_chassis")
+        : Base(name) {}
+
+    // Schedules for the moveTo drive gain, the turn gain, and the arc heading gain
+    GainSchedule& driveGain() { return drive_gain_; }
+    GainSchedule& turnGain() { return turn_gain_; }
+    GainSchedule& headingGain() { return heading_gain_; }
+
+    void update() override {
+        updateOdometry();
+        Base::update();
+    }
+
+    void drive(double forward, double strafe, double turn) override {
+        WheelSpeeds wheels = Kinematics::mix(forward, strafe, turn);
+        for (double& speed : wheels.wheels) speed *= Base::kMaxRpm;
+        driveWheels(wheels);
+    }
+
+    // Robot-frame velocity measured by the wheels, in/s and rad/s
+    BodyVelocity getBodyVelocity() const {
+        this->sampleEncoders();
+        return Kinematics::forward(wheelVelocity());
+    }
+
+    Position getPosition() const override {
+        updateOdometry();
+        return this->current_pos_;
+    }
+
+    void setPosition(const Position& position) override {
+        Base::setPosition(position);
+        odom_.initialized = false;
+    }
+};
+
+// Mecanum drive; the kinematics come from the config's drive type
+template<typename Config>
+class MecanumChassis : public HolonomicChassis<Config> {
+    static_assert(Config::driveType == DriveType::MECANUM, "MecanumChassis needs a MECANUM config");
+
+public:
+    explicit MecanumChassis(const std::string& name = "mecanum_chassis")
+        : HolonomicChassis<Config>(name) {}
+};
+
+} // namespace movement
@@ -0,0 +1,200 @@
+#pragma once
+#include "main.h"
+#include "movement/controller_state.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace movement {
+
+// On-disk driver log: a header followed by one frame per tick until end of file
+struct InputLogHeader {
+    static constexpr std::uint32_t kMagic = 0x52565244;    // "DRVR"
+    static constexpr std::uint16_t kVersion = 2;            // 2: both controllers per frame
+
+    std::uint32_t magic = kMagic;
+    std::uint16_t version = kVersion;
+    std::uint16_t frame_size = 0;       // sizeof(InputLogFrame) when written
+};
+
+// One controller's input within a frame
+struct InputLogController {
+    std::uint16_t buttons;
+    std::int8_t axes[kControllerAxes];
+    std::uint8_t connected;
+    std::uint8_t reserved;
+};
+
+// Both controllers are kept, so a run driven from the partner replays too
+struct InputLogFrame {
+    static constexpr int kControllers = 2;  // Master, then partner
+
+    std::uint32_t time_ms;              // Since the start of the recording
+    InputLogController controllers[kControllers];
+};
+
+// Writes both controllers' snapshots to the SD card once per tick
+class InputRecorder {
+private:
+    static constexpr std::uint32_t kFlushInterval = 100;   // Frames between flushes
+
+    FILE* file_ = nullptr;
+    std::uint32_t start_ms_ = 0;
+    std::uint32_t frames_ = 0;
+
+    static InputLogController record(const ControllerSnapshot& snapshot) {
+        InputLogController controller{snapshot.buttons, {}, snapshot.connected, 0};
+        for (int i = 0; i < kControllerAxes; i++) controller.axes[i] = snapshot.axes[i];
+        return controller;
+    }
+
+public:
+    ~InputRecorder() { stop(); }
+
+    bool start(const std::string& path) {
+        stop();
+        if (!pros::usd::is_installed()) return false;
+
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) return false;
+
+        InputLogHeader header;
+        header.frame_size = sizeof(InputLogFrame);
+        if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+            stop();
+            return false;
+        }
+        start_ms_ = pros::millis();
+        frames_ = 0;
+        return true;
+    }
+
+    // Call once per tick after both controllers are sampled
+    void write(const ControllerSnapshot& master, const ControllerSnapshot& partner) {
+        if (!file_) return;
+
+        InputLogFrame frame{master.timestamp - start_ms_, {record(master), record(partner)}};
+        std::fwrite(&frame, sizeof(frame), 1, file_);
+
+        // Flush now and then so a killed task loses at most a second of driving
+        if (++frames_ % kFlushInterval == 0) std::fflush(file_);
+    }
+
+    void stop() {
+        if (file_) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    bool isRecording() const { return file_ != nullptr; }
+    std::uint32_t getFrameCount() const { return frames_; }
+};
+
+// A driver log read into memory. Reading touches no playback state, so it can
+// be done on any task and handed to InputReplay::load() later.
+struct InputLog {
+    std::vector<InputLogFrame> frames;
+
+    // False if the file is missing or not a driver log
+    bool read(const std::string& path) {
+        frames.clear();
+        if (!pros::usd::is_installed()) return false;
+
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        InputLogHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  header.magic == InputLogHeader::kMagic &&
+                  header.version == InputLogHeader::kVersion &&
+                  header.frame_size == sizeof(InputLogFrame);
+
+        InputLogFrame frame;
+        while (ok && std::fread(&frame, sizeof(frame), 1, file) == 1) {
+            frames.push_back(frame);
+        }
+        std::fclose(file);
+        if (!ok) frames.clear();
+        return !frames.empty();
+    }
+};
+
+// Plays a recorded driver log back in place of both controllers
+class InputReplay {
+private:
+    // Feeds one controller's half of each frame
+    class Channel : public ControllerSource {
+    private:
+        InputReplay& replay_;
+        int index_;
+
+    public:
+        Channel(InputReplay& replay, int index) : replay_(replay), index_(index) {}
+        bool read(ControllerSnapshot& snapshot) override { return replay_.read(index_, snapshot); }
+    };
+
+    std::vector<InputLogFrame> frames_;     // Loaded up front; playback never allocates
+    Channel channels_[InputLogFrame::kControllers]{{*this, 0}, {*this, 1}};
+    size_t index_ = 0;
+    std::uint32_t start_ms_ = 0;
+    bool playing_ = false;
+
+    // Frames are chosen by recorded time, so loop jitter does not stretch the run
+    bool read(int controller, ControllerSnapshot& snapshot) {
+        if (!playing_) return false;
+
+        std::uint32_t elapsed = pros::millis() - start_ms_;
+        while (index_ + 1 < frames_.size() && frames_[index_ + 1].time_ms <= elapsed) {
+            index_++;
+        }
+        if (index_ + 1 >= frames_.size() && elapsed > frames_.back().time_ms) {
+            playing_ = false;
+            return false;
+        }
+
+        const auto& recorded = frames_[index_].controllers[controller];
+        snapshot.buttons = recorded.buttons;
+        for (int i = 0; i < kControllerAxes; i++) snapshot.axes[i] = recorded.axes[i];
+        snapshot.connected = recorded.connected != 0;
+        return true;
+    }
+
+public:
+    InputReplay() = default;
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    // Take over a log read ahead of time; false if it is empty
+    bool load(InputLog log) {
+        playing_ = false;
+        frames_ = std::move(log.frames);
+        return !frames_.empty();
+    }
+
+    // Read a whole log into memory; false if it is missing or not a driver log
+    bool load(const std::string& path) {
+        InputLog log;
+        log.read(path);
+        return load(std::move(log));
+    }
+
+    void start() {
+        index_ = 0;
+        start_ms_ = pros::millis();
+        playing_ = !frames_.empty();
+    }
+
+    void stop() { playing_ = false; }
+
+    // Source standing in for one controller: 0 master, 1 partner
+    ControllerSource& getSource(int controller) { return channels_[controller]; }
+
+    bool isPlaying() const { return playing_; }
+    bool isLoaded() const { return !frames_.empty(); }
+    std::uint32_t getDuration() const { return frames_.empty() ? 0 : frames_.back().time_ms; }
+};
+
+} // namespace movement
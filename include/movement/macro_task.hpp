@@ -0,0 +1,200 @@
+#pragma once
+#include "main.h"
+#include "movement/chassis.hpp"
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace movement {
+
+// Something a macro coroutine can co_await. The awaiter lives in the coroutine
+// frame while suspended, so polling it each tick never allocates.
+class MacroAwaitable {
+public:
+    virtual ~MacroAwaitable() = default;
+
+    // Polled once per tick while the macro is suspended on it
+    virtual bool ready() = 0;
+
+    bool await_ready() { return ready(); }
+    void await_resume() {}
+
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) {
+        handle.promise().waiting = this;
+    }
+};
+
+// Macro written as a C++20 coroutine. It suspends at every co_await and is
+// resumed at most once per tick by its owner; destroying it cancels the macro
+// at whatever point it is suspended.
+class MacroTask {
+public:
+    struct promise_type {
+        MacroAwaitable* waiting = nullptr;
+        std::exception_ptr error;
+
+        MacroTask get_return_object() {
+            return MacroTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+
+    explicit MacroTask(std::coroutine_handle<promise_type> handle)
+        : handle_(handle) {}
+
+public:
+    MacroTask() = default;
+    MacroTask(MacroTask&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    MacroTask& operator=(MacroTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    MacroTask(const MacroTask&) = delete;
+    MacroTask& operator=(const MacroTask&) = delete;
+
+    ~MacroTask() { reset(); }
+
+    // Run until the next co_await that is not ready yet; false once finished
+    bool resume() {
+        if (done()) return false;
+
+        auto& promise = handle_.promise();
+        if (promise.waiting && !promise.waiting->ready()) return true;
+        promise.waiting = nullptr;
+
+        handle_.resume();
+        if (promise.error) std::rethrow_exception(std::exchange(promise.error, nullptr));
+        return !handle_.done();
+    }
+
+    bool done() const { return !handle_ || handle_.done(); }
+
+    // Destroy the coroutine frame, running the destructors of anything it was awaiting
+    void reset() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+};
+
+// Wait for a number of milliseconds
+class Delay : public MacroAwaitable {
+private:
+    std::uint32_t start_;
+    std::uint32_t duration_;
+
+public:
+    explicit Delay(std::uint32_t ms)
+        : start_(pros::millis()), duration_(ms) {}
+
+    bool ready() override { return pros::millis() - start_ >= duration_; }
+};
+
+// Wait until a condition holds
+template<typename Condition>
+class WaitUntil : public MacroAwaitable {
+private:
+    Condition condition_;
+
+public:
+    explicit WaitUntil(Condition condition)
+        : condition_(std::move(condition)) {}
+
+    bool ready() override { return condition_(); }
+};
+
+// Start a chassis motion and wait for it to finish. The chassis steps the
+// motion from its own update(); a macro cancelled mid-motion stops the chassis.
+template<typename ChassisConfig>
+class ChassisMotion : public MacroAwaitable {
+protected:
+    Chassis<ChassisConfig>& chassis_;
+    std::uint32_t id_ = 0;
+
+public:
+    explicit ChassisMotion(Chassis<ChassisConfig>& chassis)
+        : chassis_(chassis) {}
+
+    ChassisMotion(const ChassisMotion&) = delete;
+    ChassisMotion& operator=(const ChassisMotion&) = delete;
+
+    // Cancelling also drops the rest of the queue, which this motion was part of
+    ~ChassisMotion() override {
+        if (chassis_.getMotionResult(id_) == MotionResult::RUNNING) chassis_.cancelMotion();
+    }
+
+    // Finished, replaced by another motion, or never started (chassis disabled)
+    bool ready() override { return chassis_.getMotionResult(id_) != MotionResult::RUNNING; }
+
+    // `co_await` yields how the motion ended
+    MotionResult await_resume() const { return chassis_.getMotionResult(id_); }
+};
+
+template<typename ChassisConfig>
+class MoveTo : public ChassisMotion<ChassisConfig> {
+public:
+    MoveTo(Chassis<ChassisConfig>& chassis, const field::Point& target, bool reverse = false,
+           const MotionOptions& options = {})
+        : ChassisMotion<ChassisConfig>(chassis) {
+        this->id_ = chassis.startMoveTo(target, reverse, options);
+    }
+};
+
+template<typename ChassisConfig>
+class TurnTo : public ChassisMotion<ChassisConfig> {
+public:
+    TurnTo(Chassis<ChassisConfig>& chassis, double angle, const MotionOptions& options = {})
+        : ChassisMotion<ChassisConfig>(chassis) {
+        this->id_ = chassis.startTurnTo(angle, options);
+    }
+};
+
+template<typename ChassisConfig>
+class SwingTo : public ChassisMotion<ChassisConfig> {
+public:
+    SwingTo(Chassis<ChassisConfig>& chassis, double angle, SwingSide locked, const MotionOptions& options = {})
+        : ChassisMotion<ChassisConfig>(chassis) {
+        this->id_ = chassis.startSwingTo(angle, locked, options);
+    }
+};
+
+template<typename ChassisConfig>
+class ArcTo : public ChassisMotion<ChassisConfig> {
+public:
+    ArcTo(Chassis<ChassisConfig>& chassis, double angle, double radius, bool reverse = false,
+          const MotionOptions& options = {})
+        : ChassisMotion<ChassisConfig>(chassis) {
+        this->id_ = chassis.startArcTo(angle, radius, reverse, options);
+    }
+};
+
+// Drive through a list of waypoints without stopping; waits for the last one.
+// The path queues behind a motion that is still running, so an early exit
+// from the motion before it carries straight on.
+template<typename ChassisConfig>
+class FollowPath : public ChassisMotion<ChassisConfig> {
+public:
+    FollowPath(Chassis<ChassisConfig>& chassis, const std::vector<field::Point>& points, bool reverse = false,
+               const MotionOptions& options = {})
+        : ChassisMotion<ChassisConfig>(chassis) {
+        this->id_ = chassis.followPath(points, reverse, options);
+    }
+};
+
+} // namespace movement
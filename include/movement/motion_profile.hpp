@@ -0,0 +1,62 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+namespace movement {
+
+// Velocity limits for a profiled motion
+struct ProfileLimits {
+    double max_speed = 1.0;         // Fraction of the drive's top speed
+    double max_accel = 60.0;        // in/s^2, also used to decelerate
+};
+
+// Trapezoidal velocity profile over a fixed distance: accelerate, cruise,
+// decelerate. Short moves never reach cruise and become a triangle.
+class TrapezoidProfile {
+private:
+    double distance_ = 0.0;         // Inches, non-negative
+    double velocity_ = 0.0;         // Cruise speed actually reached, in/s
+    double accel_ = 1.0;
+    double accel_time_ = 0.0;
+    double cruise_time_ = 0.0;
+
+public:
+    struct State {
+        double position;            // Inches from the start
+        double velocity;            // in/s
+    };
+
+    TrapezoidProfile() = default;
+
+    TrapezoidProfile(double distance, double max_velocity, double max_accel)
+        : distance_(std::abs(distance))
+        , accel_(std::max(max_accel, 1e-6)) {
+        max_velocity = std::max(max_velocity, 1e-6);
+
+        // Peak speed of a triangle profile; capped at max_velocity it cruises
+        velocity_ = std::min(max_velocity, std::sqrt(distance_ * accel_));
+        accel_time_ = velocity_ / accel_;
+        double accel_distance = velocity_ * accel_time_;    // Up and down ramps together
+        cruise_time_ = (distance_ - accel_distance) / velocity_;
+    }
+
+    double duration() const { return 2.0 * accel_time_ + cruise_time_; }
+
+    // Where the profile is t seconds after the start
+    State sample(double t) const {
+        if (t <= 0.0) return {0.0, 0.0};
+        if (t >= duration()) return {distance_, 0.0};
+
+        if (t < accel_time_) {
+            return {0.5 * accel_ * t * t, accel_ * t};
+        }
+        double ramp = 0.5 * velocity_ * accel_time_;
+        if (t < accel_time_ + cruise_time_) {
+            return {ramp + velocity_ * (t - accel_time_), velocity_};
+        }
+        double remaining = duration() - t;
+        return {distance_ - 0.5 * accel_ * remaining * remaining, accel_ * remaining};
+    }
+};
+
+} // namespace movement
@@ -0,0 +1,214 @@
+#pragma once
+#include "main.h"
+#include "constants/fieldConstants.hpp"
+#include "core/subsystem.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace movement {
+
+// Gravity in field units, for converting IMU accelerations
+constexpr double kGravityInPerSec2 = 386.09;
+
+// Position tracking class
+class Position {
+public:
+    double x;
+    double y;
+    double heading; // Radians
+
+    Position(double x = 0, double y = 0, double heading = 0)
+        : x(x), y(y), heading(heading) {}
+
+    double distanceTo(const field::Point& target) const {
+        double dx = target.x - x;
+        double dy = target.y - y;
+        return std::sqrt(dx*dx + dy*dy);
+    }
+
+    double angleTo(const field::Point& target) const {
+        return std::atan2(target.y - y, target.x - x);
+    }
+};
+
+// Position with a 3x3 (x, y, heading) covariance estimate
+class Pose : public Position {
+public:
+    std::array<double, 9> covariance{}; // Row-major, inches^2 / radians^2
+
+    Pose(double x = 0, double y = 0, double heading = 0)
+        : Position(x, y, heading) {}
+
+    Pose(const Position& position)
+        : Position(position) {}
+
+    double cov(int row, int col) const { return covariance[row * 3 + col]; }
+
+    // One-sigma position uncertainty in inches
+    double positionStdDev() const { return std::sqrt(cov(0, 0) + cov(1, 1)); }
+
+    // One-sigma heading uncertainty in radians
+    double headingStdDev() const { return std::sqrt(cov(2, 2)); }
+
+    // Grow the covariance for a step of `distance` along `heading` with the given
+    // variances on distance travelled and heading change
+    void propagate(double distance, double var_distance, double var_heading) {
+        propagate(distance, heading, var_distance, var_heading);
+    }
+
+    // Same for a step in field direction `direction`, for drives that strafe
+    void propagate(double distance, double direction, double var_distance, double var_heading) {
+        double c = std::cos(direction);
+        double s = std::sin(direction);
+
+        // Jacobian of the motion model with respect to the previous pose
+        const std::array<double, 9> F = {
+            1, 0, -distance * s,
+            0, 1,  distance * c,
+            0, 0,  1
+        };
+
+        std::array<double, 9> FP{};
+        for (int r = 0; r < 3; r++)
+            for (int k = 0; k < 3; k++)
+                for (int j = 0; j < 3; j++)
+                    FP[r * 3 + j] += F[r * 3 + k] * covariance[k * 3 + j];
+
+        std::array<double, 9> next{};
+        for (int r = 0; r < 3; r++)
+            for (int k = 0; k < 3; k++)
+                for (int j = 0; j < 3; j++)
+                    next[r * 3 + j] += FP[r * 3 + k] * F[j * 3 + k];
+
+        // Process noise mapped through the input Jacobian [c 0; s 0; 0 1]
+        next[0] += c * c * var_distance;
+        next[1] += c * s * var_distance;
+        next[3] += c * s * var_distance;
+        next[4] += s * s * var_distance;
+        next[8] += var_heading;
+
+        covariance = next;
+    }
+};
+
+// Odometry health reported each tick
+struct OdometryQuality {
+    bool slipping = false;
+    bool collision = false;
+    double yaw_rate_error = 0.0;    // Encoder minus IMU yaw rate, rad/s
+    double accel_error = 0.0;       // Encoder minus IMU forward acceleration, in/s^2
+    double encoder_weight = 1.0;    // Trust placed in wheel encoders for translation
+    double speed_scale = 1.0;       // Multiplier controllers apply to their output
+};
+
+// Odometry events published on "odometry_event"
+enum class OdometryEventType {
+    SLIP_START,
+    SLIP_END,
+    COLLISION
+};
+
+struct OdometryEvent {
+    OdometryEventType type;
+    std::uint32_t timestamp;
+    double magnitude;               // Yaw-rate (rad/s) or acceleration (in/s^2) error
+};
+
+// Online wheel-slip and collision detector. Compares the yaw rate and forward
+// acceleration implied by the wheel encoders with what the IMU measures.
+class SlipDetector {
+private:
+    // Detection thresholds
+    // Yaw-rate error allowed: a share of the wheel-measured rate, since tank
+    // wheels scrub 15-25% in fast point turns, with a floor for slow motion
+    static constexpr double kYawSlipRatio = 0.35;
+    static constexpr double kYawSlipFloor = 0.6;                           // rad/s
+    static constexpr double kAccelSlipThreshold = 0.35 * kGravityInPerSec2;
+    static constexpr double kCollisionAccel = 1.2 * kGravityInPerSec2;
+    static constexpr int kSlipTicks = 3;            // Consecutive ticks to declare slip
+    static constexpr int kRecoverTicks = 10;        // Consecutive clean ticks to clear it
+    static constexpr std::uint32_t kCollisionHoldMs = 300;
+
+    // Responses
+    static constexpr double kSlipEncoderWeight = 0.3;
+    static constexpr double kCollisionEncoderWeight = 0.1;
+    static constexpr double kSlipSpeedScale = 0.6;
+    static constexpr double kCollisionSpeedScale = 0.3;
+
+    static constexpr double kAccelFilterGain = 0.3;
+
+    OdometryQuality quality_;
+    int slip_count_ = 0;
+    int clean_count_ = 0;
+    double encoder_accel_ = 0.0;    // Low-passed, a raw double difference is too noisy
+    std::uint32_t collision_until_ = 0;
+
+    void publish(OdometryEventType type, std::uint32_t now, double magnitude) {
+        core::EventSystem::getInstance().emit("odometry_event", OdometryEvent{type, now, magnitude});
+    }
+
+public:
+    // Feed one tick of measurements. Yaw rates in rad/s, accelerations in in/s^2.
+    const OdometryQuality& update(double encoder_yaw_rate, double imu_yaw_rate,
+                                  double encoder_accel, double imu_accel, std::uint32_t now) {
+        encoder_accel_ += kAccelFilterGain * (encoder_accel - encoder_accel_);
+
+        quality_.yaw_rate_error = encoder_yaw_rate - imu_yaw_rate;
+        quality_.accel_error = encoder_accel_ - imu_accel;
+
+        double yaw_threshold = std::max(kYawSlipFloor, kYawSlipRatio * std::abs(encoder_yaw_rate));
+        bool slip_now = std::abs(quality_.yaw_rate_error) > yaw_threshold ||
+                        std::abs(quality_.accel_error) > kAccelSlipThreshold;
+
+        if (slip_now) {
+            clean_count_ = 0;
+            if (++slip_count_ >= kSlipTicks && !quality_.slipping) {
+                quality_.slipping = true;
+                publish(OdometryEventType::SLIP_START, now,
+                        std::max(std::abs(quality_.yaw_rate_error), std::abs(quality_.accel_error)));
+            }
+        } else {
+            slip_count_ = 0;
+            if (++clean_count_ >= kRecoverTicks && quality_.slipping) {
+                quality_.slipping = false;
+                publish(OdometryEventType::SLIP_END, now, 0.0);
+            }
+        }
+
+        // A hard IMU jolt the wheels did not cause is a hit
+        if (std::abs(imu_accel) > kCollisionAccel &&
+            std::abs(quality_.accel_error) > kCollisionAccel / 2) {
+            if (!quality_.collision) {
+                publish(OdometryEventType::COLLISION, now, quality_.accel_error);
+            }
+            collision_until_ = now + kCollisionHoldMs;
+        }
+        quality_.collision = now < collision_until_;
+
+        if (quality_.collision) {
+            quality_.encoder_weight = kCollisionEncoderWeight;
+            quality_.speed_scale = kCollisionSpeedScale;
+        } else if (quality_.slipping) {
+            quality_.encoder_weight = kSlipEncoderWeight;
+            quality_.speed_scale = kSlipSpeedScale;
+        } else {
+            quality_.encoder_weight = 1.0;
+            quality_.speed_scale = 1.0;
+        }
+        return quality_;
+    }
+
+    const OdometryQuality& getQuality() const { return quality_; }
+
+    void reset() {
+        quality_ = OdometryQuality();
+        slip_count_ = 0;
+        clean_count_ = 0;
+        encoder_accel_ = 0.0;
+        collision_until_ = 0;
+    }
+};
+
+} // namespace movement
@@ -0,0 +1,123 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace movement {
+
+// Limits applied to every drive motor command, whatever its source
+struct OutputShaperConfig {
+    double max_accel = 800.0;           // RPM/s while speeding up (0 to full in 0.25 s)
+    double max_decel = 1600.0;          // RPM/s while slowing down or reversing
+    double tilt_threshold = 8.0;        // Degrees of IMU pitch or roll
+    double tilt_accel_scale = 0.3;      // Limits are multiplied by this while tilted
+    bool traction_control = true;       // Slow down and ramp gently while the wheels slip
+    double slip_accel_scale = 0.25;     // Limits are multiplied by this while slipping
+};
+
+// Per-motor slew limiter between the command sources and the motors. Requests
+// set a target; the output moves toward it by at most one tick's worth of
+// acceleration, measured from where it stood at the end of the previous tick,
+// so several writes in one tick do not compound. Call beginTick() each tick.
+class OutputShaper {
+private:
+    struct Channel {
+        double target = 0.0;            // Latest request, RPM
+        double output = 0.0;            // Latest shaped command, RPM
+        double base = 0.0;              // Output at the end of the previous tick
+        bool coasting = false;          // Left to coast; the output no longer matches the wheel
+    };
+
+    static constexpr double kMaxTickSeconds = 0.05;    // Long gaps do not allow a jump
+
+    OutputShaperConfig config_;
+    std::vector<Channel> channels_;
+    std::uint32_t tick_ms_ = 0;
+    double dt_ = 0.0;
+    double limit_scale_ = 1.0;
+    double speed_scale_ = 1.0;
+    bool started_ = false;
+
+public:
+    explicit OutputShaper(const OutputShaperConfig& config = OutputShaperConfig())
+        : config_(config) {}
+
+    void setConfig(const OutputShaperConfig& config) { config_ = config; }
+    const OutputShaperConfig& getConfig() const { return config_; }
+
+    void resize(size_t count) { channels_.resize(count); }
+
+    bool hasTick(std::uint32_t now) const { return started_ && now == tick_ms_; }
+
+    // Latch this tick's conditions; repeated calls within one millisecond do nothing.
+    // tilt in degrees; speed_scale is the odometry's slip backoff.
+    void beginTick(std::uint32_t now, double tilt, bool slipping, double speed_scale) {
+        if (started_ && now == tick_ms_) return;
+
+        dt_ = started_ ? std::min((now - tick_ms_) / 1000.0, kMaxTickSeconds) : 0.0;
+        tick_ms_ = now;
+        started_ = true;
+        for (auto& channel : channels_) channel.base = channel.output;
+
+        limit_scale_ = 1.0;
+        speed_scale_ = 1.0;
+        if (std::abs(tilt) > config_.tilt_threshold) limit_scale_ *= config_.tilt_accel_scale;
+        if (config_.traction_control) {
+            speed_scale_ = speed_scale;
+            if (slipping) limit_scale_ *= config_.slip_accel_scale;
+        }
+    }
+
+    // Shaped command for a new request on one motor
+    double apply(size_t index, double request) {
+        Channel& channel = channels_.at(index);
+        channel.target = request;
+        channel.coasting = false;
+
+        double target = request * speed_scale_;
+        double current = channel.base;
+
+        // Moving away from zero is acceleration; toward or through zero is
+        // deceleration, which stops at zero for this tick
+        bool speeding_up = current == 0.0 || (current * target > 0.0 && std::abs(target) > std::abs(current));
+        double step = (speeding_up ? config_.max_accel : config_.max_decel) * limit_scale_ * dt_;
+        if (!speeding_up && current * target < 0.0) target = 0.0;
+
+        channel.output = current + std::clamp(target - current, -step, step);
+        return channel.output;
+    }
+
+    // Re-shape the standing request; used to keep ramping motors nobody wrote
+    // this tick. Coasting motors keep coasting.
+    double advance(size_t index) {
+        const Channel& channel = channels_.at(index);
+        return channel.coasting ? channel.output : apply(index, channel.target);
+    }
+
+    double getOutput(size_t index) const { return channels_.at(index).output; }
+    double getTarget(size_t index) const { return channels_.at(index).target; }
+
+    // Forget the ramp after a stop that bypassed shaping
+    void reset() {
+        for (auto& channel : channels_) channel = Channel{};
+    }
+
+    // Forget the ramp after the motors were let coast; until seeded the
+    // output is unknown
+    void coast() {
+        for (auto& channel : channels_) channel = Channel{0.0, 0.0, 0.0, true};
+    }
+
+    bool isCoasting(size_t index) const { return channels_.at(index).coasting; }
+
+    // Pick the ramp up from a measured speed (RPM), so the first request after
+    // a coast slows the wheel from where it is rather than from zero
+    void seed(size_t index, double rpm) {
+        Channel& channel = channels_.at(index);
+        channel.output = rpm;
+        channel.base = rpm;
+    }
+};
+
+} // namespace movement
@@ -0,0 +1,201 @@
+#pragma once
+#include "main.h"
+#include "pros/motors.hpp"
+#include "core/subsystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace movement {
+
+enum class PowerLevel : std::uint8_t {
+    NORMAL,     // Not heading for the derate temperature soon
+    WARM,       // Current limited, or predicted to derate within warn_seconds
+    DERATED     // At the derate temperature; the firmware is cutting its power
+};
+
+// Published on "drive_power_warning" when a drive motor changes level
+struct PowerEvent {
+    size_t motor;                   // Drive motor index
+    PowerLevel level;
+    double temperature;             // Estimated winding temperature, deg C
+    double seconds_to_derate;       // Infinite while it is not heating toward the limit
+};
+
+struct PowerConfig {
+    double max_current = 2500.0;    // mA per motor, the firmware default
+    double total_current = 0.0;     // mA shared by the whole drive; 0 gives every motor max_current
+    double warn_seconds = 30.0;     // Warn when derating is predicted this soon at the present draw
+    double limit_seconds = 60.0;    // Limit current so that full draw takes at least this long to derate
+    double min_share = 0.4;         // Lowest limit, as a share of max_current
+    double min_speed = 0.7;         // Drive speed share while the hottest motor is at min_share
+};
+
+// Tracks drive motor temperature and current and keeps the drive out of the
+// firmware's thermal derate. A first-order model (I^2 heating, exponential
+// cooling) fills in between the motors' coarse temperature readings and
+// predicts the time left before derating. A hot motor's current limit comes
+// down to what it can draw for limit_seconds without derating, the freed
+// budget goes to the cool motors, and the drive slows so the motors on each
+// side share the load.
+class PowerManager {
+private:
+    static constexpr std::uint32_t kSampleMs = 100;     // Temperatures move slowly; spare the bus
+    static constexpr double kMaxStep = 1.0;             // Seconds; longer gaps do not jump the model
+    static constexpr double kDerateTemp = 55.0;         // Deg C where the firmware starts cutting power
+    static constexpr double kLimitMargin = 3.0;         // Deg C below derate that limited motors settle at
+    static constexpr double kAmbientTemp = 25.0;
+    static constexpr double kHeatRate = 0.037;          // Deg C per second per A^2
+    static constexpr double kCoolingTau = 300.0;        // Seconds
+    static constexpr double kSensorStep = 5.0;          // Motors report temperature in 5 deg C steps
+    static constexpr double kCurrentFilter = 0.3;       // Weight of each new current sample
+    static constexpr double kLimitDeadband = 50.0;      // mA; smaller limit changes are not sent
+    static constexpr double kNever = std::numeric_limits<double>::infinity();
+
+    struct MotorState {
+        double temperature = kAmbientTemp;  // Model estimate, deg C
+        double current = 0.0;               // Filtered draw, A
+        double limit = 0.0;                 // Last limit sent, mA; 0 until the first
+        double share = 1.0;                 // Limit wanted, as a share of max_current
+        double seconds_to_derate = kNever;
+        PowerLevel level = PowerLevel::NORMAL;
+        bool initialized = false;
+    };
+
+    PowerConfig config_;
+    std::vector<MotorState> motors_;
+    std::uint32_t last_ms_ = 0;
+    bool sampled_ = false;
+    double speed_factor_ = 1.0;
+
+    // Highest current (A) that takes at least limit_seconds to heat the motor to
+    // just under the derate temperature
+    double sustainableCurrent(double temperature) const {
+        double decay = std::exp(-config_.limit_seconds / kCoolingTau);
+        double steady = (kDerateTemp - kLimitMargin - temperature * decay) / (1.0 - decay);
+        if (steady <= kAmbientTemp) return 0.0;
+        return std::sqrt((steady - kAmbientTemp) / (kHeatRate * kCoolingTau));
+    }
+
+    // Seconds until the model reaches the derate temperature at the present current
+    static double timeToDerate(const MotorState& state) {
+        if (state.temperature >= kDerateTemp) return 0.0;
+        double steady = kAmbientTemp + kHeatRate * state.current * state.current * kCoolingTau;
+        if (steady <= kDerateTemp) return kNever;
+        return -kCoolingTau * std::log((steady - kDerateTemp) / (steady - state.temperature));
+    }
+
+    void updateModel(size_t index, const pros::Motor& motor, double dt) {
+        MotorState& state = motors_[index];
+        double reading = motor.get_temperature();
+        std::int32_t milliamps = motor.get_current_draw();
+        if (!std::isfinite(reading) || reading == PROS_ERR_F || milliamps == PROS_ERR) return;
+        double amps = milliamps / 1000.0;
+
+        if (!state.initialized) {
+            state.temperature = reading;
+            state.current = amps;
+            state.initialized = true;
+        } else {
+            state.current += (amps - state.current) * kCurrentFilter;
+            double heating = kHeatRate * state.current * state.current;
+            double cooling = (state.temperature - kAmbientTemp) / kCoolingTau;
+            state.temperature += (heating - cooling) * dt;
+        }
+        state.temperature = std::clamp(state.temperature, reading, reading + kSensorStep);
+        state.seconds_to_derate = timeToDerate(state);
+
+        // The limit follows temperature alone, so it does not chase its own effect on the draw
+        double share = sustainableCurrent(state.temperature) * 1000.0 / config_.max_current;
+        state.share = std::clamp(share, config_.min_share, 1.0);
+
+        // Warnings clear only well clear of the limit, so they do not flicker
+        PowerLevel level = PowerLevel::NORMAL;
+        if (motor.is_over_temp() == 1 || state.temperature >= kDerateTemp) {
+            level = PowerLevel::DERATED;
+        } else if (state.share < 1.0 || state.seconds_to_derate < config_.warn_seconds) {
+            level = PowerLevel::WARM;
+        } else if (state.level != PowerLevel::NORMAL && state.seconds_to_derate < 2.0 * config_.warn_seconds) {
+            level = PowerLevel::WARM;
+        }
+        if (level != state.level) {
+            state.level = level;
+            core::EventSystem::getInstance().emit("drive_power_warning",
+                PowerEvent{index, level, state.temperature, state.seconds_to_derate});
+        }
+    }
+
+    // Hot motors get their reduced limits; the rest of the budget is split
+    // evenly over the others
+    void allocate(const std::vector<pros::Motor>& motors) {
+        double budget = config_.total_current > 0.0 ? config_.total_current
+                                                    : config_.max_current * motors_.size();
+        double hot_total = 0.0;
+        size_t cool = 0;
+        double lowest = 1.0;
+        for (const auto& state : motors_) {
+            lowest = std::min(lowest, state.share);
+            if (state.share < 1.0) {
+                hot_total += state.share * config_.max_current;
+            } else {
+                cool++;
+            }
+        }
+        double per_cool = cool > 0 ? (budget - hot_total) / cool : 0.0;
+        per_cool = std::clamp(per_cool, config_.min_share * config_.max_current, config_.max_current);
+
+        for (size_t i = 0; i < motors_.size(); i++) {
+            MotorState& state = motors_[i];
+            double limit = state.share < 1.0 ? state.share * config_.max_current : per_cool;
+            if (state.limit == 0.0 || std::abs(limit - state.limit) > kLimitDeadband) {
+                motors[i].set_current_limit(static_cast<std::int32_t>(limit));
+                state.limit = limit;
+            }
+        }
+
+        double span = 1.0 - config_.min_share;
+        double t = span > 0.0 ? (lowest - config_.min_share) / span : 1.0;
+        speed_factor_ = config_.min_speed + (1.0 - config_.min_speed) * std::clamp(t, 0.0, 1.0);
+    }
+
+public:
+    explicit PowerManager(const PowerConfig& config = PowerConfig()) : config_(config) {}
+
+    void setConfig(const PowerConfig& config) { config_ = config; }
+    const PowerConfig& getConfig() const { return config_; }
+
+    // Read the drive motors and adjust their limits; call every tick, it samples at its own rate
+    void sample(std::uint32_t now, const std::vector<pros::Motor>& motors) {
+        if (sampled_ && now - last_ms_ < kSampleMs) return;
+        double dt = sampled_ ? std::min((now - last_ms_) / 1000.0, kMaxStep) : 0.0;
+        last_ms_ = now;
+        sampled_ = true;
+
+        motors_.resize(motors.size());
+        for (size_t i = 0; i < motors.size(); i++) {
+            updateModel(i, motors[i], dt);
+        }
+        allocate(motors);
+    }
+
+    // Share of full speed the drive should use while motors run hot
+    double getSpeedFactor() const { return speed_factor_; }
+
+    size_t getMotorCount() const { return motors_.size(); }
+    PowerLevel getLevel(size_t index) const { return motors_.at(index).level; }
+    double getTemperature(size_t index) const { return motors_.at(index).temperature; }
+    double getCurrent(size_t index) const { return motors_.at(index).current; }
+    double getSecondsToDerate(size_t index) const { return motors_.at(index).seconds_to_derate; }
+    double getCurrentLimit(size_t index) const { return motors_.at(index).limit; }
+
+    // Highest level over the drive
+    PowerLevel getWorstLevel() const {
+        PowerLevel worst = PowerLevel::NORMAL;
+        for (const auto& state : motors_) worst = std::max(worst, state.level);
+        return worst;
+    }
+};
+
+} // namespace movement
@@ -0,0 +1,68 @@
+#pragma once
+#include "main.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace movement {
+
+// Joystick response curve families. `factor` shapes each one:
+enum class CurveType {
+    LINEAR,         // Output follows the stick; factor unused
+    POWER,          // |x|^factor
+    EXPONENTIAL,    // (e^(factor*x) - 1) / (e^factor - 1)
+    CUBIC_BLEND,    // Linear blended with cubic; factor is the cubic weight, 0 to 1
+    PIECEWISE       // Two straight segments meeting the power curve at a 60% stick knee
+};
+
+// Response curve precomputed into a table indexed by the raw stick value (-127 to 127),
+// with the deadzone folded in. Evaluating it is a single array load.
+class ResponseCurve {
+private:
+    static constexpr int kMaxInput = 127;
+    static constexpr double kPiecewiseKnee = 0.6;
+
+    std::array<float, kMaxInput + 1> table_{};
+
+    static double shape(CurveType type, double x, double factor) {
+        switch (type) {
+            case CurveType::LINEAR:
+                return x;
+            case CurveType::POWER:
+                return std::pow(x, factor);
+            case CurveType::EXPONENTIAL:
+                return factor > 0.0 ? std::expm1(factor * x) / std::expm1(factor) : x;
+            case CurveType::CUBIC_BLEND: {
+                double w = std::clamp(factor, 0.0, 1.0);
+                return (1.0 - w) * x + w * x * x * x;
+            }
+            case CurveType::PIECEWISE: {
+                double knee_out = std::pow(kPiecewiseKnee, factor);
+                if (x <= kPiecewiseKnee) return x * knee_out / kPiecewiseKnee;
+                return knee_out + (x - kPiecewiseKnee) * (1.0 - knee_out) / (1.0 - kPiecewiseKnee);
+            }
+        }
+        return x;
+    }
+
+public:
+    ResponseCurve(CurveType type = CurveType::LINEAR, double factor = 1.0, double deadzone = 0.0) {
+        build(type, factor, deadzone);
+    }
+
+    // Recompute the table; call only when the driver settings change
+    void build(CurveType type, double factor, double deadzone) {
+        for (int i = 0; i <= kMaxInput; i++) {
+            double x = static_cast<double>(i) / kMaxInput;
+            table_[i] = x < deadzone ? 0.0f : static_cast<float>(shape(type, x, factor));
+        }
+    }
+
+    // Curved output from -1.0 to 1.0 for a raw stick value
+    float operator()(int raw) const {
+        int magnitude = std::min(raw < 0 ? -raw : raw, kMaxInput);
+        return raw < 0 ? -table_[magnitude] : table_[magnitude];
+    }
+};
+
+} // namespace movement
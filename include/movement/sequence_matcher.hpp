@@ -0,0 +1,115 @@
+#pragma once
+#include "main.h"
+#include "movement/controller_state.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace movement {
+
+// One button press in the history ring
+struct PressEvent {
+    std::uint32_t timestamp;
+    std::uint8_t button;        // Bit index, see buttonBit()
+};
+
+// Fixed-size ring of the most recent presses; never allocates
+template<size_t Capacity>
+class PressHistory {
+private:
+    std::array<PressEvent, Capacity> events_{};
+    size_t head_ = 0;           // Slot the next press is written to
+    size_t count_ = 0;
+
+public:
+    void push(const PressEvent& event) {
+        events_[head_] = event;
+        head_ = (head_ + 1) % Capacity;
+        if (count_ < Capacity) count_++;
+    }
+
+    // age 0 is the newest press
+    const PressEvent& fromNewest(size_t age) const {
+        return events_[(head_ + Capacity - 1 - age) % Capacity];
+    }
+
+    size_t size() const { return count_; }
+    void clear() { count_ = 0; }
+};
+
+// Matches every registered button sequence in a single backward walk over the
+// press history. Sequences are stored in a trie keyed newest-press-first, so a
+// walk from the latest press visits every sequence that could end on it.
+class SequenceMatcher {
+public:
+    static constexpr size_t kHistorySize = 16;
+
+private:
+    struct Node {
+        std::array<std::int16_t, kControllerButtons> next;
+        std::int16_t sequence = -1;     // Id of the sequence ending here, or -1
+        std::uint32_t window_ms = 0;    // Max time from its first to its last press
+
+        Node() { next.fill(-1); }
+    };
+
+    std::vector<Node> nodes_{Node()};   // Root at index 0; grows only in addSequence()
+    PressHistory<kHistorySize> history_;
+
+public:
+    // Register a sequence; longer sequences win when several end on the same press
+    void addSequence(const std::vector<pros::controller_digital_e_t>& buttons,
+                     std::uint32_t window_ms, int id) {
+        if (buttons.empty() || buttons.size() > kHistorySize) return;
+
+        size_t node = 0;
+        for (auto it = buttons.rbegin(); it != buttons.rend(); ++it) {
+            int button = *it - pros::E_CONTROLLER_DIGITAL_L1;
+            if (nodes_[node].next[button] < 0) {
+                nodes_[node].next[button] = static_cast<std::int16_t>(nodes_.size());
+                nodes_.emplace_back();
+            }
+            node = nodes_[node].next[button];
+        }
+        nodes_[node].sequence = static_cast<std::int16_t>(id);
+        nodes_[node].window_ms = window_ms;
+    }
+
+    void clear() {
+        nodes_.assign(1, Node());
+        history_.clear();
+    }
+
+    // Record this tick's presses and return the id of the sequence they complete, or -1
+    int update(const ControllerSnapshot& input) {
+        std::uint16_t pressed = input.pressed();
+        if (!pressed) return -1;
+
+        for (int i = 0; i < kControllerButtons; i++) {
+            if (pressed & (1u << i)) {
+                history_.push(PressEvent{input.timestamp, static_cast<std::uint8_t>(i)});
+            }
+        }
+
+        const PressEvent& newest = history_.fromNewest(0);
+        int match = -1;
+        size_t node = 0;
+        for (size_t age = 0; age < history_.size(); age++) {
+            const PressEvent& event = history_.fromNewest(age);
+            std::int16_t next = nodes_[node].next[event.button];
+            if (next < 0) break;
+            node = next;
+
+            const Node& n = nodes_[node];
+            if (n.sequence >= 0 && newest.timestamp - event.timestamp <= n.window_ms) {
+                match = n.sequence;
+            }
+        }
+
+        // A completed combo consumes its presses
+        if (match >= 0) history_.clear();
+        return match;
+    }
+};
+
+} // namespace movement
@@ -10,9 +10,11 @@ class TankChassis : public Chassis<Config> {
 private:
     using Base = Chassis<Config>;
     using Base::motors_;
+    using Base::encoders_;
     using Base::enabled_;
     using Base::current_pos_;
-    using Base::imu_;
+    using Base::heading_;
+    using Base::slip_detector_;
 
     std::unique_ptr<pros::Rotation> left_encoder_;
     std::unique_ptr<pros::Rotation> right_encoder_;
@@ -22,110 +24,269 @@ private:
     static constexpr double kI = 0.001;
     static constexpr double kD = 0.2;
     static constexpr double kTurnP = 1.2;
+    static constexpr double kSettleRadius = 4.0;    // Inches; inside it moveTo stops steering
+    static constexpr double kCurveHeadingP = 4.0;   // Extra turn rate (rad/s) per radian behind the reference heading
+
+    // Gains scheduled on battery voltage and payload; flat at the constants above until configured
+    GainSchedule drive_gain_{kP};
+    GainSchedule turn_gain_{kTurnP};
+    GainSchedule heading_gain_{kCurveHeadingP};
+
+    // Odometry noise model
+    static constexpr double kDistanceNoise = 0.02;          // Std dev per inch travelled
+    static constexpr double kImuHeadingNoise = 0.0005;      // Std dev per tick with an IMU, rad
+    static constexpr double kEncoderHeadingNoise = 0.01;    // Std dev per inch of wheel difference
+    static constexpr double kMaxOdomStep = 0.1;             // Seconds; longer gaps skip slip checks
+
+    // Odometry state carried between ticks
+    struct OdomState {
+        double left = 0.0;              // Side travel at the last update, inches
+        double right = 0.0;
+        double velocity = 0.0;          // Fused forward velocity, in/s
+        double encoder_velocity = 0.0;  // Wheel-only forward velocity, in/s
+        std::uint32_t last_ms = 0;      // Brain time of the last update
+        std::uint32_t data_ms = 0;      // Device timestamp of the encoder data used
+        bool initialized = false;
+    };
+    mutable OdomState odom_;
+
+    // True when tracking wheels, not the drive motors, measure travel
+    bool usesTrackingWheels() const {
+        if constexpr (Config::odomType == OdomType::TRACKING) {
+            return left_encoder_ && right_encoder_;
+        }
+        return false;
+    }
+
+    // Motor index range [begin, end) for one side
+    std::pair<size_t, size_t> sideRange(bool left) const {
+        size_t half = motors_.size() / 2;
+        return left ? std::make_pair(size_t{0}, half) : std::make_pair(half, motors_.size());
+    }
+
+    // Distance travelled by one side, in inches
+    double sideTravel(bool left) const {
+        if (usesTrackingWheels()) {
+            const auto& encoder = left ? left_encoder_ : right_encoder_;
+            // Rotation sensors report centidegrees
+            return encoder->get_position() / 36000.0 * (Config::trackingWheelDiameter * M_PI);
+        }
+
+        auto [begin, end] = sideRange(left);
+        if (begin == end) return 0.0;
+
+        double degrees = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            degrees += encoders_[i].getPosition();
+        }
+        degrees /= (end - begin);
+        return degrees / 360.0 * (Config::wheelDiameter * M_PI) * Config::gearRatio;
+    }
+
+    // Filtered speed of one side from the motor encoders, in inches per second
+    double sideVelocity(bool left) const {
+        auto [begin, end] = sideRange(left);
+        if (begin == end) return 0.0;
+
+        double degrees_per_sec = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            degrees_per_sec += encoders_[i].getVelocity();
+        }
+        degrees_per_sec /= (end - begin);
+        return degrees_per_sec / 360.0 * (Config::wheelDiameter * M_PI) * Config::gearRatio;
+    }
+
+    // Integrate wheel travel and IMU heading into the pose whenever new encoder data arrives.
+    // Time steps come from the motors' own timestamps, not from our loop period.
+    void updateOdometry() const {
+        if constexpr (Config::odomType == OdomType::NONE) return;
+
+        std::uint32_t now = pros::millis();
+        if (odom_.initialized && now == odom_.last_ms) return;
+        odom_.last_ms = now;
+
+        bool fresh = this->sampleEncoders();
+        if (odom_.initialized && !fresh && !motors_.empty()) return; // No new encoder data yet
+        std::uint32_t data_ms = motors_.empty() ? now : this->encoder_timestamp_;
+
+        double left = sideTravel(true);
+        double right = sideTravel(false);
+        bool has_imu = heading_.hasImus();
+        double heading = has_imu ? heading_.getHeading() : current_pos_.heading;
+
+        if (!odom_.initialized) {
+            odom_ = OdomState{left, right, 0.0, 0.0, now, data_ms, true};
+            current_pos_.heading = heading;
+            return;
+        }
+
+        double dt = (data_ms - odom_.data_ms) / 1000.0;
+        if (dt <= 0.0) return;
+
+        double dl = left - odom_.left;
+        double dr = right - odom_.right;
+        double encoder_dtheta = (dl - dr) / Config::trackWidth; // Clockwise positive, like the IMU
+        double dtheta = has_imu ? heading - current_pos_.heading : encoder_dtheta;
+
+        // Tracking wheels have no timestamps; motor speeds come from the alpha-beta estimator
+        double encoder_velocity, encoder_yaw_rate;
+        if (usesTrackingWheels()) {
+            encoder_velocity = (dl + dr) / 2.0 / dt;
+            encoder_yaw_rate = encoder_dtheta / dt;
+        } else {
+            double left_velocity = sideVelocity(true);
+            double right_velocity = sideVelocity(false);
+            encoder_velocity = (left_velocity + right_velocity) / 2.0;
+            encoder_yaw_rate = (left_velocity - right_velocity) / Config::trackWidth;
+        }
+        double velocity = (dl + dr) / 2.0 / dt;
+
+        // After a long gap (e.g. pushed while disabled) just take the wheel travel
+        if (has_imu && dt <= kMaxOdomStep) {
+            double encoder_accel = (encoder_velocity - odom_.encoder_velocity) / dt;
+            double imu_accel = heading_.getForwardAccel() * kGravityInPerSec2;
+            const auto& quality = slip_detector_.update(
+                encoder_yaw_rate, dtheta / dt, encoder_accel, imu_accel, now);
+
+            // Lean on the IMU-propagated velocity while the wheels cannot be trusted
+            double imu_velocity = odom_.velocity + imu_accel * dt;
+            velocity = quality.encoder_weight * velocity +
+                       (1.0 - quality.encoder_weight) * imu_velocity;
+        }
+
+        double distance = velocity * dt;
+        double encoder_weight = slip_detector_.getQuality().encoder_weight;
+        double var_distance = std::pow(kDistanceNoise * distance, 2) / encoder_weight;
+        double var_heading = has_imu ? kImuHeadingNoise * kImuHeadingNoise
+                                     : std::pow(kEncoderHeadingNoise * (dl - dr), 2);
+        current_pos_.propagate(distance, var_distance, var_heading);
+
+        double mid_heading = current_pos_.heading + dtheta / 2.0;
+        current_pos_.x += distance * std::cos(mid_heading);
+        current_pos_.y += distance * std::sin(mid_heading);
+        current_pos_.heading += dtheta;
+
+        odom_ = OdomState{left, right, velocity, encoder_velocity, now, data_ms, true};
+    }
+
+protected:
+    void beginSensorCalibration() override {
+        Base::beginSensorCalibration();
+        if (left_encoder_) left_encoder_->reset_position();
+        if (right_encoder_) right_encoder_->reset_position();
+    }
+
+    // Raise a command's magnitude to at least min_speed, keeping its sign
+    static double applyMinSpeed(double power, double min_speed) {
+        if (min_speed <= 0.0 || std::abs(power) >= min_speed) return power;
+        return power < 0.0 ? -min_speed : min_speed;
+    }
+
+    // Command both sides in RPM, scaled down together to what the battery can
+    // deliver so the turn keeps its shape when a side would saturate
+    void driveSides(double left, double right) {
+        double peak = std::max(std::abs(left), std::abs(right));
+        double limit = this->maxRpm();
+        double scale = peak > limit ? limit / peak : 1.0;
+
+        for (size_t i = 0; i < motors_.size(); i++) {
+            bool is_left = i < motors_.size()/2;
+            this->writeMotor(i, (is_left ? left : right) * scale);
+        }
+    }
+
+    double stepMoveTo(const field::Point& target, bool reverse, double min_speed) override {
+        Position current = this->getPosition();
+        double distance = current.distanceTo(target);
+
+        double angle_error = current.angleTo(target) - current.heading;
+        if (reverse) angle_error += M_PI;
+        angle_error = wrapAngle(angle_error);
+
+        // Steering at a point the robot is about to pass swings the heading
+        // around and it circles the target, so close in it only drives along its heading
+        double turn_power = distance > kSettleRadius ? this->scheduled(turn_gain_) * angle_error : 0.0;
+
+        // Only the part of the distance along the heading is driven; once past
+        // the target this goes negative and backs up
+        double drive_power = std::clamp(this->scheduled(drive_gain_) * distance * std::cos(angle_error), -1.0, 1.0);
+        drive_power = applyMinSpeed(drive_power, min_speed);
+        if (reverse) drive_power = -drive_power;
+
+        // Scale to velocity; the output shaper backs off while the wheels slip
+        driveSides((drive_power + turn_power) * Base::kMaxRpm, (drive_power - turn_power) * Base::kMaxRpm);
+        return distance;
+    }
+
+    double stepTurnTo(double angle, double min_speed) override {
+        double current = this->getPosition().heading;
+        double error = wrapAngle(angle - current);
+
+        double power = applyMinSpeed(std::clamp(this->scheduled(turn_gain_) * error, -1.0, 1.0), min_speed);
+
+        driveSides(power * Base::kMaxRpm, -power * Base::kMaxRpm);
+        return std::abs(error);
+    }
+
+    // Side speeds from center speed and turn rate (clockwise positive: left side faster)
+    void driveCurve(double velocity, double yaw_rate, double heading_error,
+                    bool swing, SwingSide locked) override {
+        double turn = yaw_rate + this->scheduled(heading_gain_) * heading_error;
+        double left = velocity + turn * Config::trackWidth / 2.0;
+        double right = velocity - turn * Config::trackWidth / 2.0;
+
+        // A swing pivots on the locked side, so the other side covers the whole track width
+        if (swing) {
+            left = locked == SwingSide::LEFT ? 0.0 : turn * Config::trackWidth;
+            right = locked == SwingSide::RIGHT ? 0.0 : -turn * Config::trackWidth;
+        }
+
+        // in/s to motor RPM; the motors' velocity loops hold it at any voltage
+        double to_rpm = Base::kMaxRpm / Base::topSpeed();
+        driveSides(left * to_rpm, right * to_rpm);
+    }
 
 public:
     explicit TankChassis(const std::string& name = "tank_chassis") 
         : Base(name) {}
 
+    // Schedules for the moveTo drive gain, the turn gain, and the arc heading gain
+    GainSchedule& driveGain() { return drive_gain_; }
+    GainSchedule& turnGain() { return turn_gain_; }
+    GainSchedule& headingGain() { return heading_gain_; }
+
     void initializeSensors(int imu_port, int left_enc_port = -1, int right_enc_port = -1) override {
-        Base::initializeSensors(imu_port);
-        
         if constexpr (Config::odomType == OdomType::TRACKING) {
             if (left_enc_port != -1) {
                 left_encoder_ = std::make_unique<pros::Rotation>(left_enc_port);
-                left_encoder_->reset_position();
             }
             if (right_enc_port != -1) {
                 right_encoder_ = std::make_unique<pros::Rotation>(right_enc_port);
-                right_encoder_->reset_position();
             }
         }
+
+        Base::initializeSensors(imu_port);
     }
 
-    void moveTo(const field::Point& target, bool reverse = false) override {
-        if (!enabled_) return;
-
-        while (enabled_) {
-            Position current = this->getPosition();
-            double distance = current.distanceTo(target);
-            
-            if (distance < 1.0) break; // 1 inch tolerance
-            
-            double angle_error = current.angleTo(target) - current.heading;
-            if (reverse) angle_error += M_PI;
-            
-            // Normalize angle error
-            while (angle_error > M_PI) angle_error -= 2*M_PI;
-            while (angle_error < -M_PI) angle_error += 2*M_PI;
-            
-            // Calculate motor powers using PID
-            double turn_power = kTurnP * angle_error;
-            double drive_power = kP * distance;
-            
-            // Apply powers to motors
-            for (size_t i = 0; i < motors_.size(); i++) {
-                bool is_left = i < motors_.size()/2;
-                double power = drive_power + (is_left ? turn_power : -turn_power);
-                motors_[i].move_velocity(power * 200); // Scale to velocity
-            }
-            
-            pros::delay(10);
-        }
-        
-        this->stop();
-    }
-
-    void turnTo(double angle) override {
-        if (!enabled_) return;
-
-        while (enabled_) {
-            double current = this->getPosition().heading;
-            double error = angle - current;
-            
-            // Normalize error
-            while (error > M_PI) error -= 2*M_PI;
-            while (error < -M_PI) error += 2*M_PI;
-            
-            if (std::abs(error) < 0.05) break; // ~3 degree tolerance
-            
-            double power = kTurnP * error;
-            
-            // Apply powers to motors
-            for (size_t i = 0; i < motors_.size(); i++) {
-                bool is_left = i < motors_.size()/2;
-                motors_[i].move_velocity((is_left ? power : -power) * 200);
-            }
-            
-            pros::delay(10);
-        }
-        
-        this->stop();
+    void update() override {
+        updateOdometry();
+        Base::update();
+    }
+
+    void drive(double forward, double strafe, double turn) override {
+        (void)strafe;   // A tank drive cannot move sideways
+        driveSides((forward + turn) * Base::kMaxRpm, (forward - turn) * Base::kMaxRpm);
     }
 
     Position getPosition() const override {
-        if constexpr (Config::odomType == OdomType::IMU_ENHANCED) {
-            if (imu_) {
-                double heading = imu_->get_heading() * M_PI / 180.0;
-                return Position(this->current_pos_.x, this->current_pos_.y, heading);
-            }
-        }
-        else if constexpr (Config::odomType == OdomType::TRACKING) {
-            if (imu_ && left_encoder_ && right_encoder_) {
-                double left_dist = left_encoder_->get_position() / 360.0 * (2.75 * M_PI);
-                double right_dist = right_encoder_->get_position() / 360.0 * (2.75 * M_PI);
-                double heading = imu_->get_heading() * M_PI / 180.0;
-                
-                double distance = (left_dist + right_dist) / 2.0;
-                double new_x = this->current_pos_.x + distance * std::cos(heading);
-                double new_y = this->current_pos_.y + distance * std::sin(heading);
-                
-                this->current_pos_.x = new_x;
-                this->current_pos_.y = new_y;
-                this->current_pos_.heading = heading;
-            }
-        }
+        updateOdometry();
         return this->current_pos_;
     }
+
+    void setPosition(const Position& position) override {
+        Base::setPosition(position);
+        odom_.initialized = false;
+    }
 };
 
 } // namespace movement
@@ -0,0 +1,100 @@
+#pragma once
+#include "main.h"
+#include "pros/motors.hpp"
+#include <cstdint>
+
+namespace movement {
+
+// Alpha-beta tracker for position and velocity from timestamped samples.
+// Uses the sample's own timestamp, so irregular data arrival does not skew velocity.
+class AlphaBetaFilter {
+private:
+    double alpha_;
+    double beta_;
+    double position_ = 0.0;
+    double velocity_ = 0.0;        // Position units per second
+    std::uint32_t last_time_ = 0;
+    bool initialized_ = false;
+
+public:
+    explicit AlphaBetaFilter(double alpha = 0.5, double beta = 0.1)
+        : alpha_(alpha), beta_(beta) {}
+
+    // Returns false when the sample carries no new data (same timestamp)
+    bool update(double measurement, std::uint32_t timestamp_ms) {
+        if (!initialized_) {
+            position_ = measurement;
+            velocity_ = 0.0;
+            last_time_ = timestamp_ms;
+            initialized_ = true;
+            return true;
+        }
+        if (timestamp_ms == last_time_) return false;
+
+        double dt = (timestamp_ms - last_time_) / 1000.0;
+        double predicted = position_ + velocity_ * dt;
+        double residual = measurement - predicted;
+
+        position_ = predicted + alpha_ * residual;
+        velocity_ += beta_ / dt * residual;
+        last_time_ = timestamp_ms;
+        return true;
+    }
+
+    double getPosition() const { return position_; }
+    double getVelocity() const { return velocity_; }
+    std::uint32_t getTimestamp() const { return last_time_; }
+    bool isInitialized() const { return initialized_; }
+
+    void reset() {
+        initialized_ = false;
+        position_ = 0.0;
+        velocity_ = 0.0;
+    }
+};
+
+// Motor encoder read through get_raw_position() with its device-side timestamp
+class MotorEncoder {
+private:
+    AlphaBetaFilter filter_;
+    double degrees_per_count_ = 0.0;    // Resolved from the cartridge on first read
+    double position_ = 0.0;             // Latest unfiltered position, degrees
+    std::uint32_t timestamp_ = 0;       // Device timestamp of the latest count, ms
+
+    static double countsPerRev(pros::MotorGears gearing) {
+        switch (gearing) {
+            case pros::MotorGears::red:  return 1800.0;
+            case pros::MotorGears::blue: return 300.0;
+            default:                     return 900.0;
+        }
+    }
+
+public:
+    MotorEncoder() : filter_(0.4, 0.08) {}
+
+    // Read the motor once; returns true when the device reported a new count.
+    // Counts follow the motor's reverse flag, as get_position() does.
+    bool sample(const pros::Motor& motor) {
+        if (degrees_per_count_ == 0.0) {
+            degrees_per_count_ = 360.0 / countsPerRev(motor.get_gearing());
+        }
+
+        std::uint32_t timestamp = 0;
+        std::int32_t counts = motor.get_raw_position(&timestamp);
+        if (counts == PROS_ERR) return false;
+
+        position_ = counts * degrees_per_count_;
+        bool fresh = filter_.update(position_, timestamp);
+        timestamp_ = timestamp;
+        return fresh;
+    }
+
+    double getPosition() const { return position_; }           // Degrees
+    double getVelocity() const { return filter_.getVelocity(); } // Degrees per second
+    double getRpm() const { return filter_.getVelocity() / 6.0; }
+    std::uint32_t getTimestamp() const { return timestamp_; }
+
+    void reset() { filter_.reset(); }
+};
+
+} // namespace movement
@@ -1,12 +1,22 @@
 #pragma once
 #include "main.h"
 #include "core/subsystem.hpp"
+#include "movement/auton_script.hpp"
+#include "movement/auton_selector.hpp"
 #include "movement/chassis.hpp"
 #include "movement/tank_chassis.hpp"
 #include "movement/control_system.hpp"
+#include "movement/controller_manager.hpp"
 #include "movement/driver_control.hpp"
+#include "movement/holonomic_chassis.hpp"
+#include "movement/input_recording.hpp"
 #include "subsystems/clamp.hpp"
+#include "subsystems/controller_feedback.hpp"
+#include <cmath>
+#include <cstdio>
 #include <memory>
+#include <string>
+#include <type_traits>
 
 // Global configuration for the robot
 struct RobotConfig {
@@ -15,13 +25,28 @@ struct RobotConfig {
         std::vector<int> left_motor_ports;
         std::vector<int> right_motor_ports;
         int imu_port;
+        std::vector<int> extra_imu_ports;   // Fused with imu_port for heading
+        movement::HeadingFusion heading_fusion = movement::HeadingFusion::MEDIAN;
+        movement::OutputShaperConfig shaping;   // Acceleration, anti-tip and traction limits
+        movement::BatteryConfig battery;        // Voltage compensation
+        // Gain multipliers: a sagging battery and a carried goal both slow the
+        // response, so the gains rise. Starting points; tune on the robot.
+        movement::GainScaling drive_gain{{{11.0, 1.15}, {12.5, 1.0}}, 1.1};
+        movement::GainScaling turn_gain{{{11.0, 1.2}, {12.5, 1.0}}, 1.2};
+        movement::PowerConfig power;            // Thermal derate avoidance
     } chassis;
     struct {
         char port;
     } clamp;
     struct {
         movement::DriveMode mode = movement::DriveMode::SPLIT;
+        int controller_id = movement::kMasterController;   // Drive priority; the other controller drives while it rests
+        bool allow_recording = false;       // Hold X for 1 s to start/stop recording
+        std::string recording_path = "/usd/driver_run.bin";
     } driver;
+    struct {
+        std::string script_path = "/usd/auton.bin";  // Compiled with tools/compile_auton.py
+    } auton;
 };
 
 class RobotState {
@@ -30,9 +55,19 @@ private:
     struct MainChassisConfig : movement::ChassisConfig<movement::DriveType::TANK, movement::OdomType::IMU_ENHANCED> {
         // Add any custom chassis configuration here if needed
     };
+
+    // Switching the drive type above to MECANUM or HOLONOMIC builds the X-drive practice bot;
+    // autonomous code is the same either way
+    using MainChassis = std::conditional_t<MainChassisConfig::driveType == movement::DriveType::TANK,
+                                           movement::TankChassis<MainChassisConfig>,
+                                           movement::HolonomicChassis<MainChassisConfig>>;
     
     RobotConfig config_;
-    pros::Controller master_{pros::E_CONTROLLER_MASTER};
+    movement::ControllerManager controllers_;       // Sampled once per tick in update()
+    movement::InputRecorder recorder_;
+    movement::InputReplay replay_;
+    movement::AutonSelector auton_selector_;
+    int shown_sensor_status_ = -1;                  // Last sensor line drawn: -1 none, 0 calibrating, 1 ready
     
     // Singleton instance
     static std::unique_ptr<RobotState> instance_;
@@ -46,7 +81,7 @@ private:
         auto& registry = core::SubsystemRegistry::getInstance();
 
         // Initialize chassis
-        auto chassis = std::make_shared<movement::TankChassis<MainChassisConfig>>("main_chassis");
+        auto chassis = std::make_shared<MainChassis>("main_chassis");
         
         // Configure motors
         for (int port : config_.chassis.left_motor_ports) {
@@ -55,8 +90,17 @@ private:
         for (int port : config_.chassis.right_motor_ports) {
             chassis->addMotor(port, true);  // Right side reversed
         }
+        chassis->setOutputShaping(config_.chassis.shaping);
+        chassis->setBatteryConfig(config_.chassis.battery);
+        chassis->driveGain().apply(config_.chassis.drive_gain);
+        chassis->turnGain().apply(config_.chassis.turn_gain);
+        chassis->setPowerConfig(config_.chassis.power);
 
         if (!config_.dev_mode) {
+            for (int port : config_.chassis.extra_imu_ports) {
+                chassis->addImu(port);
+            }
+            chassis->getHeadingService().setFusion(config_.chassis.heading_fusion);
             chassis->initializeSensors(config_.chassis.imu_port);
         }
 
@@ -65,18 +109,29 @@ private:
         // Initialize clamp subsystem
         auto clamp = subsystems::Clamp::create("main_clamp", config_.clamp.port, config_.dev_mode);
 
+        // Scheduled gains switch to their loaded values while the clamp holds a goal
+        core::EventSystem::getInstance().subscribe<bool>("clamp_state_changed",
+            [chassis](const bool& is_clamped) { chassis->setPayload(is_clamped); });
+
+        // Rate-limited controller screen and rumble output
+        auto feedback = subsystems::ControllerFeedback::create("main_feedback", controllers_.getController(movement::kMasterController), config_.dev_mode);
+
         // Initialize control systems
         auto driver = std::make_shared<movement::DriverControl<MainChassisConfig>>(
             "main_driver",
             *chassis,
-            movement::DriverConfig{.mode = config_.driver.mode}
+            controllers_.getDrive(),
+            movement::DriverConfig{.mode = config_.driver.mode, .controller_id = config_.driver.controller_id}
         );
+        driver->setReplayInput(&controllers_.getMaster());
         registry.registerSubsystem(driver);
+        controllers_.setArbitration(movement::ControllerArbitration{.priority = config_.driver.controller_id});
 
         // Initialize input mapper and macro system
         auto input_mapper = std::make_shared<movement::InputMapper<MainChassisConfig>>(
             "main_input_mapper",
-            master_
+            controllers_.getMaster(),
+            controllers_.getPartner()
         );
         registry.registerSubsystem(input_mapper);
 
@@ -86,6 +141,10 @@ private:
         );
         registry.registerSubsystem(macro_system);
 
+        // The routine picked before the match, prepared in the background
+        macro_system->registerMacro("auton", std::make_unique<movement::SelectedRoutine>(auton_selector_,
+            [chassis](const movement::Position& start) { chassis->setPosition(start); }));
+
         // Initialize enhanced driver control
         auto enhanced_driver = std::make_shared<movement::EnhancedDriverControl<MainChassisConfig>>(
             "main_enhanced_driver",
@@ -95,12 +154,98 @@ private:
         );
         registry.registerSubsystem(enhanced_driver);
 
-        setupControls(input_mapper, clamp);
+        // Interpreter for autonomous scripts on the SD card
+        auto script = std::make_shared<movement::AutonScript<MainChassisConfig>>(
+            "main_script",
+            *chassis,
+            [clamp](movement::ClampCommand command) {
+                switch (command) {
+                    case movement::ClampCommand::RELEASE: clamp->setClamp(false); break;
+                    case movement::ClampCommand::GRAB:    clamp->setClamp(true); break;
+                    case movement::ClampCommand::TOGGLE:  clamp->toggle(); break;
+                }
+            }
+        );
+        registry.registerSubsystem(script);
+
+        setupControls(input_mapper, clamp, feedback);
+        setupTelemetry();
+    }
+
+    // Short warning for a drive motor running hot, e.g. "M3 WARM 20s" or "M3 HOT 57C"; empty once it is fine
+    static std::string powerText(const movement::PowerEvent& event) {
+        char text[24];
+        unsigned motor = static_cast<unsigned>(event.motor + 1);
+        if (event.level == movement::PowerLevel::DERATED) {
+            snprintf(text, sizeof(text), "M%u HOT %.0fC", motor, event.temperature);
+        } else if (event.level == movement::PowerLevel::WARM && std::isfinite(event.seconds_to_derate)) {
+            snprintf(text, sizeof(text), "M%u WARM %.0fs", motor, event.seconds_to_derate);
+        } else if (event.level == movement::PowerLevel::WARM) {
+            // Limited but not heating toward derate at the present draw
+            snprintf(text, sizeof(text), "M%u WARM %.0fC", motor, event.temperature);
+        } else {
+            return "";
+        }
+        return text;
+    }
+
+    // Stream notable events to the PROS terminal (debug output in dev mode) and the brain screen
+    void setupTelemetry() {
+        if (config_.dev_mode) {
+            core::EventSystem::getInstance().subscribe<movement::OdometryEvent>("odometry_event",
+                [](const movement::OdometryEvent& event) {
+                    const char* type = "slip_end";
+                    if (event.type == movement::OdometryEventType::SLIP_START) type = "slip_start";
+                    if (event.type == movement::OdometryEventType::COLLISION) type = "collision";
+                    printf("[odom] t=%lu %s %.2f\n", static_cast<unsigned long>(event.timestamp), type, event.magnitude);
+                });
+
+            // Motions cut short by a stall or timeout point at odometry or tuning problems
+            core::EventSystem::getInstance().subscribe<movement::MotionEvent>("motion_finished",
+                [](const movement::MotionEvent& event) {
+                    const char* result = nullptr;
+                    if (event.result == movement::MotionResult::STALLED) result = "stalled";
+                    if (event.result == movement::MotionResult::TIMEOUT) result = "timeout";
+                    if (!result) return;
+                    printf("[motion] id=%lu %s after %lums, error %.2f\n", static_cast<unsigned long>(event.id),
+                           result, static_cast<unsigned long>(event.duration_ms), event.error);
+                });
+        }
+
+        // Drive motors heading for thermal derate, also on the brain screen's last line
+        core::EventSystem::getInstance().subscribe<movement::PowerEvent>("drive_power_warning",
+            [this](const movement::PowerEvent& event) {
+                if (config_.dev_mode) {
+                    printf("[power] motor %u level %d at %.0fC", static_cast<unsigned>(event.motor + 1),
+                           static_cast<int>(event.level), event.temperature);
+                    if (std::isfinite(event.seconds_to_derate)) printf(", derate in %.0fs", event.seconds_to_derate);
+                    printf("\n");
+                }
+                if (!pros::lcd::is_initialized()) return;
+                if (event.level != movement::PowerLevel::NORMAL ||
+                    getChassis().getPowerManager().getWorstLevel() == movement::PowerLevel::NORMAL) {
+                    pros::lcd::set_text(7, powerText(event));
+                }
+            });
+
+        // Script problems go on the brain screen's status line, under the routine selector
+        core::EventSystem::getInstance().subscribe<movement::ScriptErrorEvent>("script_error",
+            [](const movement::ScriptErrorEvent& event) {
+                if (!pros::lcd::is_initialized()) return;
+                char text[32];
+                if (event.fault == movement::ScriptFault::INVALID) {
+                    snprintf(text, sizeof(text), "Script invalid, not loaded");
+                } else {
+                    snprintf(text, sizeof(text), "Script: block %u skipped", static_cast<unsigned>(event.pc));
+                }
+                pros::lcd::set_text(5, text);
+            });
     }
 
     void setupControls(
         const std::shared_ptr<movement::InputMapper<MainChassisConfig>>& input_mapper,
-        const std::shared_ptr<subsystems::Clamp>& clamp
+        const std::shared_ptr<subsystems::Clamp>& clamp,
+        const std::shared_ptr<subsystems::ControllerFeedback>& feedback
     ) {
         if (input_mapper && clamp) {
             // Configure clamp control binding
@@ -112,11 +257,55 @@ private:
                 [clamp]() { clamp->toggle(); });
         }
 
-        // Subscribe to clamp state changes for potential feedback
-        core::EventSystem::getInstance().subscribe<bool>("clamp_state_changed",
-            [this](const bool& is_clamped) {
-                // Could add controller rumble or other feedback here
+        // Abort whatever autonomous code is driving, e.g. a runaway macro
+        if (input_mapper) {
+            movement::InputBinding cancel_binding{
+                .type = movement::InputType::BUTTON,
+                .buttons = {pros::E_CONTROLLER_DIGITAL_B}
+            };
+            input_mapper->addBinding("cancel_motion", cancel_binding, [this]() { preempt(); });
+        }
+
+        // Pushing a stick during a motion hands the drive back to the driver
+        core::EventSystem::getInstance().subscribe<bool>("driver_preempt",
+            [this](const bool&) { preempt(movement::StopBehavior::COAST); });
+
+        if (input_mapper && config_.driver.allow_recording) {
+            movement::InputBinding record_binding{
+                .type = movement::InputType::HOLD,
+                .buttons = {pros::E_CONTROLLER_DIGITAL_X},
+                .hold_time = std::chrono::milliseconds(1000)
+            };
+            input_mapper->addBinding("toggle_recording", record_binding, [this]() {
+                if (isRecording()) {
+                    stopRecording();
+                } else {
+                    startRecording(config_.driver.recording_path);
+                }
             });
+        }
+
+        // Clamp state on the controller; queued, so the event never waits on the radio
+        if (feedback) {
+            core::EventSystem::getInstance().subscribe<bool>("clamp_state_changed",
+                [feedback](const bool& is_clamped) {
+                    feedback->rumble(is_clamped ? "." : "-");
+                    feedback->setText(0, is_clamped ? "Clamp: ON" : "Clamp: OFF");
+                });
+            core::EventSystem::getInstance().subscribe<int>("drive_owner_changed",
+                [feedback](const int& owner) {
+                    feedback->setText(1, owner == movement::kPartnerController ? "Drive: PARTNER" : "Drive: MASTER");
+                });
+            core::EventSystem::getInstance().subscribe<movement::PowerEvent>("drive_power_warning",
+                [this, feedback](const movement::PowerEvent& event) {
+                    if (event.level == movement::PowerLevel::WARM) feedback->rumble("..");
+                    if (event.level == movement::PowerLevel::DERATED) feedback->rumble("--");
+                    if (event.level != movement::PowerLevel::NORMAL ||
+                        getChassis().getPowerManager().getWorstLevel() == movement::PowerLevel::NORMAL) {
+                        feedback->setText(2, powerText(event));
+                    }
+                });
+        }
     }
 
 public:
@@ -136,16 +325,79 @@ public:
 
     // Main update loop
     void update() {
+        controllers_.sample();
+
         auto& registry = core::SubsystemRegistry::getInstance();
         registry.updateAll();
     }
 
+    // Resume every subsystem at the start of autonomous / driver control
+    void enable() {
+        core::SubsystemRegistry::getInstance().enableAll();
+    }
+
+    // Stop everything that drives the chassis on its own: the active motion,
+    // macros that need the chassis, and the SD card script
+    void preempt(movement::StopBehavior behavior = movement::StopBehavior::BRAKE) {
+        getChassis().cancelMotion(behavior);
+        if (auto macro_system = getMacroSystem()) {
+            macro_system->interrupt(movement::RESOURCE_CHASSIS);
+        }
+        if (auto script = getSubsystem<movement::AutonScript<MainChassisConfig>>("main_script")) {
+            script->stop();
+        }
+    }
+
+    // Driver input recording to the SD card
+    bool startRecording(const std::string& path) {
+        if (!recorder_.start(path)) return false;
+        controllers_.setRecorder(&recorder_);
+        return true;
+    }
+
+    void stopRecording() {
+        controllers_.setRecorder(nullptr);
+        recorder_.stop();
+    }
+
+    bool isRecording() const { return recorder_.isRecording(); }
+
+    // Replay a recorded run through DriverControl and InputMapper in place of both controllers
+    bool startReplay(const std::string& path) {
+        return loadReplay(path) && playReplay();
+    }
+
+    // Split form of startReplay(); call from the task that plays the replay.
+    // Autonomous plans read an InputLog in the background and pass it to playReplay(log).
+    bool loadReplay(const std::string& path) { return replay_.load(path); }
+
+    // Play a log read ahead of time, e.g. by an autonomous plan on the prepare task
+    bool playReplay(movement::InputLog log) {
+        return replay_.load(std::move(log)) && playReplay();
+    }
+
+    bool playReplay() {
+        if (!replay_.isLoaded()) return false;
+        replay_.start();
+        controllers_.getMaster().setSource(&replay_.getSource(movement::kMasterController));
+        controllers_.getPartner().setSource(&replay_.getSource(movement::kPartnerController));
+        return true;
+    }
+
+    void stopReplay() {
+        controllers_.getMaster().setSource(nullptr);
+        controllers_.getPartner().setSource(nullptr);
+        replay_.stop();
+    }
+
+    bool isReplaying() const { return replay_.isPlaying(); }
+
     // Reset robot state
     void reset() {
         auto& registry = core::SubsystemRegistry::getInstance();
         
         if (!config_.dev_mode) {
-            if (auto chassis = registry.getSubsystemByType<movement::Chassis<MainChassisConfig>>()) {
+            if (auto chassis = registry.getSubsystem<movement::Chassis<MainChassisConfig>>("main_chassis")) {
                 chassis->initializeSensors(config_.chassis.imu_port);
             }
         }
@@ -174,15 +426,93 @@ public:
         throw std::runtime_error("Clamp subsystem not initialized");
     }
 
+    // Controller screen/rumble queue; null before initialization
+    std::shared_ptr<subsystems::ControllerFeedback> getFeedback() {
+        return getSubsystem<subsystems::ControllerFeedback>("main_feedback");
+    }
+
+    std::shared_ptr<movement::MacroSystem<MainChassisConfig>> getMacroSystem() {
+        return getSubsystem<movement::MacroSystem<MainChassisConfig>>("main_macro");
+    }
+
+    // Load the SD card script and start it; false if there is none
+    bool startScript() {
+        return loadScript() && runScript();
+    }
+
+    // Split form of startScript(); call from the task that runs the script, blue mirrors it.
+    // Autonomous plans read in the background with readScript() instead.
+    bool loadScript(movement::Alliance alliance = movement::Alliance::RED) {
+        auto script = getSubsystem<movement::AutonScript<MainChassisConfig>>("main_script");
+        return script && script->load(config_.auton.script_path, alliance == movement::Alliance::BLUE);
+    }
+
+    bool runScript() {
+        auto script = getSubsystem<movement::AutonScript<MainChassisConfig>>("main_script");
+        if (!script || !script->isLoaded()) return false;
+        script->start();
+        return true;
+    }
+
+    // Read the SD card script without touching the interpreter, so it can run on
+    // any task; blue mirrors it. runScript(program) installs and starts it.
+    bool readScript(movement::ScriptProgram& program, movement::Alliance alliance) const {
+        if (!program.read(config_.auton.script_path)) return false;
+        if (alliance == movement::Alliance::BLUE) program.mirror();
+        return true;
+    }
+
+    bool runScript(const movement::ScriptProgram& program) {
+        auto script = getSubsystem<movement::AutonScript<MainChassisConfig>>("main_script");
+        return script && script->load(program) && runScript();
+    }
+
+    bool isScriptRunning() {
+        auto script = getSubsystem<movement::AutonScript<MainChassisConfig>>("main_script");
+        return script && script->isRunning();
+    }
+
+    // Autonomous routine selection; add routines in initialize()
+    movement::AutonSelector& getAutonSelector() { return auton_selector_; }
+
     // Getter for chassis subsystem specifically
     movement::Chassis<MainChassisConfig>& getChassis() {
-        if (auto chassis = getSubsystemByType<movement::Chassis<MainChassisConfig>>()) {
+        // Looked up by name: the type cache is keyed on the concrete chassis, not the Chassis base
+        if (auto chassis = getSubsystem<movement::Chassis<MainChassisConfig>>("main_chassis")) {
             return *chassis;
         }
         throw std::runtime_error("Chassis subsystem not initialized");
     }
 
     bool isDevMode() const { return config_.dev_mode; }
+
+    // Sensor readiness (dev mode has no sensors to wait for)
+    bool areSensorsReady() {
+        return config_.dev_mode || getChassis().areSensorsReady();
+    }
+
+    // Keep refining the IMU bias while the robot waits between periods, and
+    // save it to the SD card here where a slow write cannot delay a control step
+    void idle() {
+        showSensorStatus();
+        if (!config_.dev_mode) {
+            getChassis().refineHeadingBias();
+            getChassis().saveHeadingBias();
+        }
+    }
+
+    // Calibration progress on line 6 of the brain screen, redrawn only when it changes
+    void showSensorStatus() {
+        if (!pros::lcd::is_initialized()) return;
+        int status = areSensorsReady() ? 1 : 0;
+        if (status == shown_sensor_status_) return;
+        shown_sensor_status_ = status;
+        pros::lcd::set_text(6, status ? "Sensors: READY" : "Sensors: CALIBRATING");
+    }
+
+    bool waitForSensors(std::uint32_t timeout_ms = 3000) {
+        return config_.dev_mode || getChassis().waitForSensors(timeout_ms);
+    }
 };
 
 // Initialize static member
@@ -0,0 +1,118 @@
+#pragma once
+#include "main.h"
+#include "pros/misc.hpp"
+#include "core/subsystem.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace subsystems {
+
+// Controller feedback configuration
+struct ControllerFeedbackConfig : public core::SubsystemConfig {
+    std::uint32_t min_interval_ms = 50;     // Controller drops packets sent faster than this
+
+    ControllerFeedbackConfig(bool dev = false) {
+        dev_mode = dev;
+    }
+};
+
+// Rate-limited queue for controller screen text and rumble. Callers never block;
+// the newest request for each line (and for rumble) replaces any stale one, and
+// at most one packet goes out per allowed slot.
+class ControllerFeedback : public core::Subsystem<ControllerFeedbackConfig> {
+public:
+    static constexpr int kLines = 3;
+    static constexpr int kLineWidth = 15;
+    static constexpr int kMaxRumble = 8;
+
+private:
+    struct LineSlot {
+        char text[kLineWidth + 1] = {};
+        bool dirty = false;
+    };
+
+    pros::Controller& controller_;
+    std::array<LineSlot, kLines> lines_;
+    char rumble_[kMaxRumble + 1] = {};
+    bool rumble_pending_ = false;
+    int next_line_ = 0;                     // Round-robin start for dirty lines
+    std::uint32_t last_send_ = 0;
+
+    // Send one queued packet; rumble goes first so feedback is felt promptly
+    void sendNext() {
+        if (rumble_pending_) {
+            if (!config_.dev_mode) controller_.rumble(rumble_);
+            rumble_pending_ = false;
+            return;
+        }
+
+        for (int i = 0; i < kLines; i++) {
+            int line = (next_line_ + i) % kLines;
+            if (!lines_[line].dirty) continue;
+
+            if (!config_.dev_mode) controller_.set_text(line, 0, lines_[line].text);
+            lines_[line].dirty = false;
+            next_line_ = (line + 1) % kLines;
+            return;
+        }
+    }
+
+public:
+    ControllerFeedback(const std::string& name, pros::Controller& controller,
+                       const ControllerFeedbackConfig& config)
+        : core::Subsystem<ControllerFeedbackConfig>(name, config)
+        , controller_(controller) {}
+
+    void update() override {
+        std::uint32_t now = pros::millis();
+        if (now - last_send_ < config_.min_interval_ms) return;
+        if (!rumble_pending_ && !hasPendingText()) return;
+
+        sendNext();
+        last_send_ = now;
+    }
+
+    // Queue text for a screen line, padded so it fully overwrites the previous text
+    void setText(int line, const std::string& text) {
+        if (line < 0 || line >= kLines) return;
+        char padded[kLineWidth + 1];
+        std::snprintf(padded, sizeof(padded), "%-*.*s", kLineWidth, kLineWidth, text.c_str());
+        if (std::strcmp(padded, lines_[line].text) == 0) return; // Already shown or queued
+
+        std::memcpy(lines_[line].text, padded, sizeof(padded));
+        lines_[line].dirty = true;
+    }
+
+    // Queue a rumble pattern ('.' short, '-' long, ' ' pause); replaces any pending one
+    void rumble(const char* pattern) {
+        std::snprintf(rumble_, sizeof(rumble_), "%s", pattern);
+        rumble_pending_ = true;
+    }
+
+    void clear() {
+        for (int line = 0; line < kLines; line++) setText(line, "");
+    }
+
+    bool hasPendingText() const {
+        for (const auto& slot : lines_) {
+            if (slot.dirty) return true;
+        }
+        return false;
+    }
+
+    // Factory method for easy creation and registration
+    static std::shared_ptr<ControllerFeedback> create(const std::string& name,
+                                                      pros::Controller& controller,
+                                                      bool dev_mode = false) {
+        ControllerFeedbackConfig config(dev_mode);
+        auto feedback = std::make_shared<ControllerFeedback>(name, controller, config);
+        core::SubsystemRegistry::getInstance().registerSubsystem(feedback);
+        return feedback;
+    }
+};
+
+} // namespace subsystems
@@ -4,12 +4,26 @@
 
 namespace movement {
 
+// Example coroutine macros; each co_await yields to the scheduler until it completes
+template<typename ChassisConfig>
+MacroTask turn180(Chassis<ChassisConfig>& chassis) {
+    co_await TurnTo(chassis, M_PI);
+}
+
+template<typename ChassisConfig>
+MacroTask squarePattern(Chassis<ChassisConfig>& chassis) {
+    for (int i = 0; i < 4; i++) {
+        co_await MoveTo(chassis, field::Point{24.0, 0.0});
+        co_await TurnTo(chassis, M_PI/2);
+    }
+}
+
 // Example helper function to setup a complete control system
 template<typename ChassisConfig>
 std::unique_ptr<EnhancedDriverControl<ChassisConfig>> setupControlSystem(
     const std::string& name,
     Chassis<ChassisConfig>& chassis,
-    pros::Controller& controller
+    const ControllerState& controller
 ) {
     // Create macro system
     auto macro_system = std::make_unique<MacroSystem<ChassisConfig>>(
@@ -26,16 +40,13 @@ std::unique_ptr<EnhancedDriverControl<ChassisConfig>> setupControlSystem(
     // Register example macros
     
     // Quick turn 180 degrees macro
-    macro_system->registerMacro("turn_180", std::make_unique<MovementMacro>([&chassis]() {
-        chassis.turnTo(M_PI);
+    macro_system->registerMacro("turn_180", std::make_unique<CoroutineMacro>([&chassis]() {
+        return turn180(chassis);
     }));
 
     // Drive square pattern macro
-    macro_system->registerMacro("square_pattern", std::make_unique<MovementMacro>([&chassis]() {
-        for (int i = 0; i < 4; i++) {
-            chassis.moveTo(field::Point{24.0, 0.0});
-            chassis.turnTo(M_PI/2);
-        }
+    macro_system->registerMacro("square_pattern", std::make_unique<CoroutineMacro>([&chassis]() {
+        return squarePattern(chassis);
     }));
 
     // Setup input bindings
@@ -66,9 +77,7 @@ std::unique_ptr<EnhancedDriverControl<ChassisConfig>> setupControlSystem(
         .threshold = 0.1
     };
     input_mapper->addBinding("drive_forward", forward_binding, [&chassis]() {
-        for (size_t i = 0; i < chassis.getMotorCount(); i++) {
-            chassis.setMotorVelocity(i, 200.0);
-        }
+        chassis.drive(1.0, 0.0, 0.0);
     });
 
     // Create and return enhanced driver control
@@ -84,12 +93,14 @@ template<typename ChassisConfig>
 void runAutonomousRoutine(MacroSystem<ChassisConfig>& macro_system) {
     macro_system.startMacro("turn_180");
     while (macro_system.isMacroActive()) {
+        macro_system.getChassis().update();
         macro_system.update();
         pros::delay(10);
     }
 
     macro_system.startMacro("square_pattern");
     while (macro_system.isMacroActive()) {
+        macro_system.getChassis().update();
         macro_system.update();
         pros::delay(10);
     }
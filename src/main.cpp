@@ -1,6 +1,98 @@
 #include "main.h"
 #include "robot_state.hpp"
 #include "constants/fieldConstants.hpp"
+#include "display/auton_selector_screen.hpp"
+
+// Autonomous steps; each runs one step per tick from MacroSystem::update()
+constexpr double kClampReach = 6.0;     // Inches from the goal to fire the clamp
+
+movement::MacroTask driveForward(RobotState& robot) {
+    auto& chassis = robot.getChassis();
+
+    // Move forward
+    chassis.drive(0.5, 0.0, 0.0); // 50% speed forward
+    co_await movement::Delay(1000);
+    chassis.stop();
+}
+
+movement::MacroTask driveTo(RobotState& robot, field::Point goal) {
+    co_await movement::MoveTo(robot.getChassis(), goal);
+}
+
+// Clamp as soon as the goal is in reach instead of after the drive settles
+movement::MacroTask clampOnArrival(RobotState& robot, field::Point goal) {
+    co_await movement::WaitUntil([&robot, goal]() {
+        return robot.getChassis().getPosition().distanceTo(goal) < kClampReach;
+    });
+    robot.getClamp().toggle();
+}
+
+// The program and log were read on the prepare task; installing them happens
+// here, on the task that runs autonomous
+movement::MacroTask runScript(RobotState& robot, std::shared_ptr<const movement::ScriptProgram> program) {
+    if (!robot.runScript(*program)) co_return;
+    co_await movement::WaitUntil([&robot]() { return !robot.isScriptRunning(); });
+}
+
+movement::MacroTask runReplay(RobotState& robot, std::shared_ptr<movement::InputLog> log) {
+    if (!robot.playReplay(std::move(*log))) co_return;
+    co_await movement::WaitUntil([&robot]() { return !robot.isReplaying(); });
+}
+
+// Red start: on the starting line in front of the near goal, facing it.
+// SD scripts are compiled for this pose too.
+const movement::Position kRedStart(36, field::start_zones::RED_ZONE.y_pos, M_PI / 2);
+
+// Routines for the pre-match selector. Builders run on a background task, so
+// file reading and macro allocation are done before autonomous starts. They must
+// not touch robot state; anything read is handed to the macro and installed
+// when it runs.
+void registerRoutines(RobotState& robot) {
+    auto& selector = robot.getAutonSelector();
+
+    selector.addRoutine(movement::AutonRoutine{
+        "Goal rush",
+        kRedStart,
+        {field::mobile_goals::BOTTOM_LEFT.position},
+        [&robot](const movement::AutonPlan& plan) {
+            field::Point goal = plan.waypoints[0];
+            return movement::sequence(
+                std::make_unique<movement::CoroutineMacro>([&robot]() { return driveForward(robot); }),
+                movement::deadline(
+                    std::make_unique<movement::CoroutineMacro>([&robot, goal]() { return driveTo(robot, goal); }),
+                    std::make_unique<movement::CoroutineMacro>([&robot, goal]() { return clampOnArrival(robot, goal); },
+                                                               movement::RESOURCE_CLAMP)
+                )
+            );
+        }
+    });
+
+    selector.addRoutine(movement::AutonRoutine{
+        "SD script",
+        kRedStart,
+        {},
+        [&robot](const movement::AutonPlan& plan) -> std::unique_ptr<movement::Macro> {
+            auto program = std::make_shared<movement::ScriptProgram>();
+            if (!robot.readScript(*program, plan.alliance)) return nullptr;
+            return std::make_unique<movement::CoroutineMacro>([&robot, program]() { return runScript(robot, program); },
+                                                              movement::RESOURCE_CHASSIS | movement::RESOURCE_CLAMP);
+        }
+    });
+
+    selector.addRoutine(movement::AutonRoutine{
+        "Driver replay",
+        kRedStart,
+        {},
+        [&robot](const movement::AutonPlan& plan) -> std::unique_ptr<movement::Macro> {
+            // Stick input cannot be mirrored; a run recorded on red only replays on red
+            if (plan.alliance != movement::Alliance::RED) return nullptr;
+            auto log = std::make_shared<movement::InputLog>();
+            if (!log->read("/usd/driver_run.bin")) return nullptr;
+            return std::make_unique<movement::CoroutineMacro>([&robot, log]() { return runReplay(robot, log); },
+                                                              movement::RESOURCE_NONE);
+        }
+    });
+}
 
 void initialize() {
     // Configure the robot
@@ -19,43 +111,53 @@ void initialize() {
     config.driver.mode = movement::DriveMode::SPLIT;  // Split arcade drive
     
     // Initialize robot with configuration
-    RobotState::getInstance(config);
+    auto& robot = RobotState::getInstance(config);
+
+    // Start preparing the default routine right away
+    pros::lcd::initialize();
+    registerRoutines(robot);
+    robot.getAutonSelector().select(0, movement::Alliance::RED);
 }
 
 void disabled() {
+    // PROS ended the autonomous or opcontrol task; drop its motions and macros
+    // so nothing resumes half-finished when the robot is enabled again
+    auto& robot = RobotState::getInstance();
+    robot.preempt();
     core::SubsystemRegistry::getInstance().disableAll();
+    robot.stopReplay();
+    robot.stopRecording();
+
+    // Robot is still while disabled; use the time to refine the IMU bias
+    while (true) {
+        robot.idle();
+        pros::delay(10);
+    }
 }
 
-void competition_initialize() {}
+void competition_initialize() {
+    auto& robot = RobotState::getInstance();
+    display::AutonSelectorScreen screen(robot.getAutonSelector());
+    screen.show();
+
+    while (true) {
+        screen.update();
+        robot.idle();
+        pros::delay(10);
+    }
+}
 
 void autonomous() {
     auto& robot = RobotState::getInstance();
-    
-    using ChassisConfig = movement::ChassisConfig<movement::DriveType::TANK, movement::OdomType::IMU_ENHANCED>;
-    
-    if (auto macro_system = robot.getSubsystemByType<movement::MacroSystem<ChassisConfig>>()) {
-        // Create and register autonomous macro
-        auto auton_macro = std::make_unique<movement::MovementMacro>([&robot]() {
-            if (auto chassis = robot.getSubsystemByType<movement::Chassis<ChassisConfig>>()) {
-                // Move forward
-                for (size_t i = 0; i < chassis->getMotorCount(); i++) {
-                    chassis->setMotorVelocity(i, 100); // 50% speed forward
-                }
-                pros::delay(1000);
-                chassis->stop();
-                
-                // Move to specific point
-                field::Point target_point(24, 0);
-                chassis->moveTo(target_point);
-            }
-            
-            if (auto clamp = robot.getSubsystem<subsystems::Clamp>("main_clamp")) {
-                clamp->toggle();
-            }
-        });
-        
-        macro_system->registerMacro("auton_routine", std::move(auton_macro));
-        macro_system->startMacro("auton_routine");
+    robot.enable();
+
+    // Sensors calibrate in the background from initialize(); hold the first motion until they finish
+    robot.waitForSensors();
+
+    // The selected routine was prepared before the match; starting it hands over the macro
+    // and places odometry at the routine's start pose
+    if (auto macro_system = robot.getMacroSystem()) {
+        macro_system->startMacro("auton");
         
         // Run autonomous loop
         while (pros::competition::is_autonomous()) {
@@ -67,6 +169,8 @@ void autonomous() {
 
 void opcontrol() {
     auto& robot = RobotState::getInstance();
+    robot.enable();
+    robot.stopReplay();
     
     // Main control loop
     while (true) {
@@ -1,6 +1,7 @@
 #include "movement/chassis.hpp"
 #include "movement/tank_chassis.hpp"
 #include "movement/driver_control.hpp"
+#include "movement/controller_state.hpp"
 #include <memory>
 
 // Robot configuration and control systems
@@ -13,6 +14,8 @@ using ChassisType = movement::TankChassis<movement::ChassisConfig<
 >>;
 
 // Global instances
+pros::Controller master(pros::E_CONTROLLER_MASTER);
+movement::ControllerState controller_state(master);
 std::unique_ptr<ChassisType> chassis;
 std::unique_ptr<movement::DriverControl<movement::ChassisConfig<
     movement::DriveType::TANK,
@@ -41,7 +44,7 @@ void initializeChassis() {
     driver = std::make_unique<movement::DriverControl<movement::ChassisConfig<
         movement::DriveType::TANK,
         movement::OdomType::IMU_ENHANCED
-    >>>("driver", *chassis, driver_config);  // Added name parameter
+    >>>("driver", *chassis, controller_state, driver_config);  // Added name parameter
 }
 
 // Autonomous movement functions
@@ -57,6 +60,7 @@ void moveToGoal() {
 // Driver control update function - call this in opcontrol loop
 void updateDriverControl() {
     if (driver) {
+        controller_state.sample();
         driver->update();
     }
 }
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Compile an autonomous script into bytecode for movement::AutonScript.
+
+Script syntax, one command per line ('#' starts a comment):
+
+    move_to <x> <y> [reverse]       drive to a field point (inches)
+    turn_to <degrees>               face a heading, clockwise positive
+    follow <x,y> <x,y> ...          drive through each point in turn without stopping
+    clamp grab|release|toggle
+    wait <ms>
+    parallel                        run the block up to 'end' alongside
+      ...                           the commands that follow it
+    end
+    join                            wait for every parallel block to finish;
+                                    not allowed inside a parallel block
+
+Only one lane should drive at a time; a new motion replaces the running one.
+
+Usage: compile_auton.py routine.txt auton.bin
+Copy the output to the SD card (default path /usd/auton.bin).
+"""
+import struct
+import sys
+
+MAGIC = 0x53545541  # "AUTS"
+VERSION = 1
+MAX_INSTRUCTIONS = 256
+
+OP_END, OP_MOVE_TO, OP_TURN_TO, OP_CLAMP, OP_WAIT, OP_FORK, OP_JOIN = range(7)
+FLAG_REVERSE = 1 << 0
+FLAG_CHAIN = 1 << 1
+CLAMP = {"release": 0, "grab": 1, "toggle": 2}
+
+
+class ScriptError(Exception):
+    pass
+
+
+def parse_point(text, line):
+    try:
+        x, y = text.split(",")
+        return float(x), float(y)
+    except ValueError:
+        raise ScriptError(f"line {line}: bad point '{text}', expected x,y")
+
+
+def compile_script(lines):
+    program = []        # (op, flags, arg, a, b)
+    forks = []          # (index of OP_FORK, source line)
+
+    for number, raw in enumerate(lines, 1):
+        words = raw.split("#", 1)[0].split()
+        if not words:
+            continue
+        cmd, args = words[0].lower(), words[1:]
+
+        try:
+            if cmd == "move_to" and len(args) in (2, 3):
+                reverse = len(args) == 3
+                if reverse and args[2] != "reverse":
+                    raise ScriptError(f"line {number}: expected 'reverse', got '{args[2]}'")
+                program.append((OP_MOVE_TO, FLAG_REVERSE if reverse else 0, 0, float(args[0]), float(args[1])))
+            elif cmd == "turn_to" and len(args) == 1:
+                program.append((OP_TURN_TO, 0, 0, float(args[0]), 0.0))
+            elif cmd == "follow" and args:
+                points = [parse_point(a, number) for a in args]
+                for i, (x, y) in enumerate(points):
+                    flags = FLAG_CHAIN if i < len(points) - 1 else 0
+                    program.append((OP_MOVE_TO, flags, 0, x, y))
+            elif cmd == "clamp" and len(args) == 1 and args[0] in CLAMP:
+                program.append((OP_CLAMP, 0, CLAMP[args[0]], 0.0, 0.0))
+            elif cmd == "wait" and len(args) == 1:
+                ms = int(args[0])
+                if not 0 <= ms <= 0xFFFF:
+                    raise ScriptError(f"line {number}: wait must be 0-65535 ms")
+                program.append((OP_WAIT, 0, ms, 0.0, 0.0))
+            elif cmd == "parallel" and not args:
+                forks.append((len(program), number))
+                program.append((OP_FORK, 0, 0, 0.0, 0.0))
+            elif cmd == "end" and not args:
+                if not forks:
+                    raise ScriptError(f"line {number}: 'end' without 'parallel'")
+                index, _ = forks.pop()
+                program[index] = (OP_FORK, 0, len(program) - index - 1, 0.0, 0.0)
+            elif cmd == "join" and not args:
+                if forks:
+                    raise ScriptError(f"line {number}: 'join' is not allowed inside 'parallel'")
+                program.append((OP_JOIN, 0, 0, 0.0, 0.0))
+            else:
+                raise ScriptError(f"line {number}: cannot parse '{raw.strip()}'")
+        except ValueError:
+            raise ScriptError(f"line {number}: bad number in '{raw.strip()}'")
+
+    if forks:
+        raise ScriptError(f"line {forks[-1][1]}: 'parallel' without 'end'")
+    program.append((OP_END, 0, 0, 0.0, 0.0))
+    if len(program) > MAX_INSTRUCTIONS:
+        raise ScriptError(f"{len(program)} instructions, limit is {MAX_INSTRUCTIONS}")
+    return program
+
+
+def encode(program):
+    data = struct.pack("<IHH", MAGIC, VERSION, len(program))
+    for op, flags, arg, a, b in program:
+        data += struct.pack("<BBHff", op, flags, arg, a, b)
+    return data
+
+
+def main(argv):
+    if len(argv) != 3:
+        print(__doc__)
+        return 2
+    with open(argv[1]) as source:
+        try:
+            program = compile_script(source.readlines())
+        except ScriptError as error:
+            print(f"{argv[1]}: {error}", file=sys.stderr)
+            return 1
+    with open(argv[2], "wb") as output:
+        output.write(encode(program))
+    print(f"{argv[2]}: {len(program)} instructions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))